@@ -0,0 +1,129 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+namespace andwass {
+/**
+ * @brief Search for a needle allowing up to `k` edits
+ *
+ * Implements the Wu-Manber extension of the bitap (shift-and) algorithm: one 64-bit state
+ * word per allowed error level, all advanced in a single pass over the haystack. The
+ * char mask table is built once on construction and reused for every haystack.
+ *
+ * An occurrence is a substring of the haystack with a Levenshtein distance of at most
+ * `max_errors()` to the needle. Since the start of an occurrence is ambiguous when edits
+ * are allowed, occurrences are reported by where they end.
+ */
+class approximate_searcher {
+public:
+    using size_type = std::size_t;
+
+    /**
+     * The longest supported needle.
+     */
+    static constexpr size_type max_needle_size = 64;
+
+private:
+    std::array<std::uint64_t, 256> masks_{};
+    size_type size_ = 0;
+    size_type max_errors_ = 0;
+
+public:
+    /**
+     * @brief Precompute the search tables for a needle
+     * @param needle The needle to search for, at most `max_needle_size` chars.
+     * @param max_errors The number of allowed insertions, deletions and substitutions.
+     *
+     * @note Throws `std::length_error` if `needle.size() > max_needle_size`
+     */
+    approximate_searcher(string_view needle, size_type max_errors): size_(needle.size()), max_errors_((std::min)(max_errors, needle.size())) {
+        if (needle.size() > max_needle_size) {
+            throw std::length_error("Needle too long for approximate_searcher");
+        }
+        for (size_type i = 0; i < needle.size(); i++) {
+            masks_[static_cast<unsigned char>(needle[i])] |= std::uint64_t(1) << i;
+        }
+    }
+
+    [[nodiscard]] size_type needle_size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] size_type max_errors() const noexcept {
+        return max_errors_;
+    }
+
+    /**
+     * @brief Call `f` with the end of every approximate occurrence
+     * @param haystack The view to search
+     * @param f Called with the index one past the last char of each occurrence, in increasing
+     * order. Iteration stops early if `f` returns `false`.
+     */
+    template<class F>
+    void for_each_end(string_view haystack, F&& f) const {
+        // With k >= m errors the needle can be deleted entirely, matching everywhere.
+        if (max_errors_ == size_) {
+            for (size_type end = 0; end <= haystack.size(); end++) {
+                if (!f(end)) {
+                    return;
+                }
+            }
+            return;
+        }
+        const std::uint64_t accept = std::uint64_t(1) << (size_ - 1);
+        // Bit i of state[d] is set if needle[0..i] matches a suffix of the text read so far with at most d errors.
+        std::array<std::uint64_t, max_needle_size + 1> state{};
+        for (size_type d = 0; d <= max_errors_; d++) {
+            state[d] = (std::uint64_t(1) << d) - 1;
+        }
+        for (size_type j = 0; j < haystack.size(); j++) {
+            const auto mask = masks_[static_cast<unsigned char>(haystack[j])];
+            auto previous = state[0];
+            state[0] = ((state[0] << 1) | 1) & mask;
+            for (size_type d = 1; d <= max_errors_; d++) {
+                const auto current = state[d];
+                // match | insertion | substitution | deletion
+                state[d] = (((current << 1) | 1) & mask) | previous | ((previous << 1) | 1) | (state[d - 1] << 1);
+                previous = current;
+            }
+            if (state[max_errors_] & accept) {
+                if (!f(j + 1)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Find where the first approximate occurrence ends
+     * @param haystack The view to search
+     * @return The index one past the last char of the first occurrence, or `npos` if not found.
+     */
+    [[nodiscard]] size_type find_end(string_view haystack) const {
+        auto retval = string_view::npos;
+        for_each_end(haystack, [&](size_type end) {
+            retval = end;
+            return false;
+        });
+        return retval;
+    }
+
+    /**
+     * @brief Check if the haystack contains an approximate occurrence
+     * @param haystack The view to search
+     * @return A value equivalent to `find_end(haystack) != npos`
+     */
+    [[nodiscard]] bool contains(string_view haystack) const {
+        return find_end(haystack) != string_view::npos;
+    }
+};
+}// namespace andwass
@@ -0,0 +1,149 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+
+#include <cstdint>
+
+namespace andwass {
+namespace detail
+{
+/**
+ * @brief Lowercase all ASCII letters in 8 packed chars at once.
+ *
+ * Bytes with the high bit set are left untouched.
+ */
+inline constexpr std::uint64_t to_lower_word(std::uint64_t word) noexcept {
+    constexpr std::uint64_t high_bits = 0x8080808080808080ull;
+    constexpr std::uint64_t low_bits = 0x7f7f7f7f7f7f7f7full;
+    constexpr std::uint64_t ones = 0x0101010101010101ull;
+    const auto heptets = word & low_bits;
+    const auto at_least_a = heptets + ones * (0x80 - 'A');
+    const auto above_z = heptets + ones * (0x80 - 'Z' - 1);
+    const auto is_upper = at_least_a & ~above_z & ~word & high_bits;
+    // 0x80 >> 2 == 0x20, the difference between 'A' and 'a'
+    return word | (is_upper >> 2);
+}
+
+template<class CharTransform>
+constexpr string_view transform_into(string_view src, char* dest, std::size_t dest_size, CharTransform transform) noexcept {
+    const auto n = (std::min)(src.size(), dest_size);
+    for(std::size_t i=0; i<n; i++) {
+        dest[i] = transform(src[i]);
+    }
+    return string_view(dest, n);
+}
+}
+
+/**
+ * @brief Convert an ASCII uppercase letter to lowercase
+ * @return The lowercase letter if `ch` is in `'A'..'Z'`, otherwise `ch`.
+ *
+ * Unlike `std::tolower` this does not depend on the current locale.
+ */
+[[nodiscard]] constexpr char to_lower_ascii(char ch) noexcept {
+    const auto uch = static_cast<unsigned char>(ch);
+    return static_cast<char>(uch + (static_cast<unsigned char>(uch - 'A') < 26 ? 0x20 : 0));
+}
+
+/**
+ * @brief Convert an ASCII lowercase letter to uppercase
+ * @return The uppercase letter if `ch` is in `'a'..'z'`, otherwise `ch`.
+ *
+ * Unlike `std::toupper` this does not depend on the current locale.
+ */
+[[nodiscard]] constexpr char to_upper_ascii(char ch) noexcept {
+    const auto uch = static_cast<unsigned char>(ch);
+    return static_cast<char>(uch - (static_cast<unsigned char>(uch - 'a') < 26 ? 0x20 : 0));
+}
+
+/**
+ * @brief Write a lowercase copy of `src` to a caller provided buffer
+ * @param src The chars to convert
+ * @param dest The buffer to write to, may be equal to `src.data()`
+ * @param dest_size The size of `dest`
+ * @return A view of the written chars, `min(src.size(), dest_size)` long.
+ *
+ * Only ASCII letters are converted. The loop is branch-free so compilers can vectorize it.
+ */
+constexpr string_view to_lower_ascii(string_view src, char* dest, std::size_t dest_size) noexcept {
+    return detail::transform_into(src, dest, dest_size, [](char ch) {
+        return to_lower_ascii(ch);
+    });
+}
+
+/**
+ * @brief Write an uppercase copy of `src` to a caller provided buffer
+ * @param src The chars to convert
+ * @param dest The buffer to write to, may be equal to `src.data()`
+ * @param dest_size The size of `dest`
+ * @return A view of the written chars, `min(src.size(), dest_size)` long.
+ *
+ * Only ASCII letters are converted. The loop is branch-free so compilers can vectorize it.
+ */
+constexpr string_view to_upper_ascii(string_view src, char* dest, std::size_t dest_size) noexcept {
+    return detail::transform_into(src, dest, dest_size, [](char ch) {
+        return to_upper_ascii(ch);
+    });
+}
+
+/**
+ * @brief Hash the ASCII lowercase form of a view without materializing it
+ * @param sv The view to hash
+ * @return A value equal to `andwass::hash` of the lowercase form of `sv`.
+ */
+[[nodiscard]] constexpr std::uint64_t hash_lower(string_view sv) noexcept {
+    return detail::hash_bytes(sv.data(), sv.size(), [](std::uint64_t word) {
+        return detail::to_lower_word(word);
+    });
+}
+
+/**
+ * @brief Compare two views for equality, ignoring ASCII case
+ * @return True if `lhs` and `rhs` are equal after converting both to ASCII lowercase.
+ *
+ * Compares 8 chars per step, folding case inside the loop.
+ */
+[[nodiscard]] constexpr bool iequals(string_view lhs, string_view rhs) noexcept {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for(std::size_t i=0; i<lhs.size(); i += 8) {
+        const auto n = (std::min)(lhs.size() - i, std::size_t(8));
+        const auto left = detail::to_lower_word(detail::load_word(lhs.data() + i, n));
+        const auto right = detail::to_lower_word(detail::load_word(rhs.data() + i, n));
+        if (left != right) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Case-insensitive (ASCII) hash for unordered containers
+ *
+ * Consistent with `iequal_to`: views that are equal ignoring ASCII case hash equally.
+ */
+struct ihash {
+    using is_transparent = void;
+
+    [[nodiscard]] constexpr std::size_t operator()(string_view sv) const noexcept {
+        return static_cast<std::size_t>(hash_lower(sv));
+    }
+};
+
+/**
+ * @brief Case-insensitive (ASCII) equality for unordered containers
+ */
+struct iequal_to {
+    using is_transparent = void;
+
+    [[nodiscard]] constexpr bool operator()(string_view lhs, string_view rhs) const noexcept {
+        return iequals(lhs, rhs);
+    }
+};
+}// namespace andwass
@@ -0,0 +1,266 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+#include <andwass/detail/bits.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace andwass {
+/**
+ * @brief A Bloom filter where all bits of a key live in one 64 byte block
+ *
+ * The library `hash` of a key selects a block, and a second mix of it selects
+ * `num_hashes()` bits in that block. A query therefore reads a single cache line, and
+ * the bits are tested by building the 8 word mask of the key and comparing it against
+ * the block in one branch-free pass.
+ *
+ * The false positive rate is slightly higher than that of a classic Bloom filter with
+ * the same number of bits, at 10 bits per key it is roughly 1%.
+ */
+class blocked_bloom_filter {
+public:
+    using size_type = std::size_t;
+
+    static constexpr size_type block_bits = 512;
+    static constexpr size_type block_words = block_bits / 64;
+
+private:
+    struct alignas(64) block {
+        std::uint64_t words[block_words];
+    };
+
+    std::vector<block> blocks_;
+    unsigned num_hashes_ = 0;
+
+    static constexpr char magic_[4] = {'A', 'W', 'B', 'F'};
+    static constexpr std::uint32_t version_ = 1;
+    static constexpr size_type header_size_ = 4 + 4 + 4 + 4 + 8;
+
+    [[nodiscard]] size_type block_index(std::uint64_t hash) const noexcept {
+        // Multiply-shift maps the upper hash bits onto [0, num_blocks) without a division.
+        return static_cast<size_type>(((hash >> 32) * blocks_.size()) >> 32);
+    }
+
+    void key_mask(std::uint64_t hash, std::uint64_t (&mask)[block_words]) const noexcept {
+        const auto mixed = detail::hash_mix(hash ^ 0x9e3779b97f4a7c15ull);
+        auto a = static_cast<std::uint32_t>(mixed);
+        const auto b = static_cast<std::uint32_t>(mixed >> 32) | 1;
+        for (auto& word: mask) {
+            word = 0;
+        }
+        for (unsigned i = 0; i < num_hashes_; ++i) {
+            const auto bit = a >> (32 - 9);
+            mask[bit / 64] |= std::uint64_t(1) << (bit % 64);
+            a += b;
+        }
+    }
+
+    void insert_hash(std::uint64_t hash) noexcept {
+        std::uint64_t mask[block_words];
+        key_mask(hash, mask);
+        auto& blk = blocks_[block_index(hash)];
+        for (size_type i = 0; i < block_words; ++i) {
+            blk.words[i] |= mask[i];
+        }
+    }
+
+    [[nodiscard]] bool contains_hash(std::uint64_t hash) const noexcept {
+        std::uint64_t mask[block_words];
+        key_mask(hash, mask);
+        const auto& blk = blocks_[block_index(hash)];
+        std::uint64_t missing = 0;
+        for (size_type i = 0; i < block_words; ++i) {
+            missing |= mask[i] & ~blk.words[i];
+        }
+        return missing == 0;
+    }
+
+    static void put_u32(std::vector<char>& out, std::uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    static void put_u64(std::vector<char>& out, std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    static std::uint64_t get_le(const char* data, int bytes) noexcept {
+        std::uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= std::uint64_t(static_cast<unsigned char>(data[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    blocked_bloom_filter(size_type num_blocks, unsigned num_hashes, int): blocks_(num_blocks, block{}), num_hashes_(num_hashes) {}
+
+public:
+    /**
+     * @brief Construct an empty filter
+     * @param expected_keys The number of keys the filter is sized for.
+     * @param bits_per_key Bits of memory per expected key, between 1 and 64.
+     *
+     * The number of bits set per key is `bits_per_key * ln(2)`, rounded and clamped to [1, 16].
+     *
+     * @note Throws `std::invalid_argument` if `bits_per_key` is out of range, and `std::length_error`
+     * if the filter would need more than `2^32` blocks.
+     */
+    explicit blocked_bloom_filter(size_type expected_keys, unsigned bits_per_key = 10) {
+        if (bits_per_key == 0 || bits_per_key > 64) {
+            throw std::invalid_argument("bits_per_key must be between 1 and 64");
+        }
+        // In 64 bits, `size_type` may be too narrow to hold the limit.
+        const auto total_bits = std::uint64_t((std::max)(expected_keys, size_type(1))) * bits_per_key;
+        const auto num_blocks = (total_bits + block_bits - 1) / block_bits;
+        if (num_blocks > (std::uint64_t(1) << 32) || num_blocks > blocks_.max_size()) {
+            throw std::length_error("Too many keys for blocked_bloom_filter");
+        }
+        blocks_.resize(static_cast<size_type>(num_blocks), block{});
+        const auto k = static_cast<long>(std::lround(bits_per_key * 0.6931471805599453));
+        num_hashes_ = static_cast<unsigned>((std::min)((std::max)(k, 1L), 16L));
+    }
+
+    /**
+     * @brief Get the number of 64 byte blocks
+     */
+    [[nodiscard]] size_type num_blocks() const noexcept {
+        return blocks_.size();
+    }
+
+    /**
+     * @brief Get the number of bits set per key
+     */
+    [[nodiscard]] unsigned num_hashes() const noexcept {
+        return num_hashes_;
+    }
+
+    /**
+     * @brief Remove all keys
+     */
+    void clear() noexcept {
+        for (auto& blk: blocks_) {
+            blk = block{};
+        }
+    }
+
+    void insert(string_view key) noexcept {
+        insert_hash(andwass::hash(key));
+    }
+
+    /**
+     * @brief Insert a range of keys convertible to `string_view`
+     */
+    template<class Iter>
+    void insert(Iter first, Iter last) {
+        constexpr size_type batch = 8;
+        std::uint64_t hashes[batch];
+        while (first != last) {
+            size_type n = 0;
+            for (; n < batch && first != last; ++n, ++first) {
+                hashes[n] = andwass::hash(string_view(*first));
+                detail::prefetch(&blocks_[block_index(hashes[n])]);
+            }
+            for (size_type i = 0; i < n; ++i) {
+                insert_hash(hashes[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Check if `key` may have been inserted
+     * @return false if `key` was definitely never inserted.
+     */
+    [[nodiscard]] bool contains(string_view key) const noexcept {
+        return contains_hash(andwass::hash(key));
+    }
+
+    /**
+     * @brief Check many keys, prefetching the blocks of several keys ahead
+     * @param first, last A range of keys convertible to `string_view`
+     * @param out Output iterator receiving the result of `contains` for every key, in order.
+     * @return The output iterator after the last result.
+     */
+    template<class Iter, class Out>
+    Out contains(Iter first, Iter last, Out out) const {
+        constexpr size_type batch = 8;
+        std::uint64_t hashes[batch];
+        while (first != last) {
+            size_type n = 0;
+            for (; n < batch && first != last; ++n, ++first) {
+                hashes[n] = andwass::hash(string_view(*first));
+                detail::prefetch(&blocks_[block_index(hashes[n])]);
+            }
+            for (size_type i = 0; i < n; ++i) {
+                *out++ = contains_hash(hashes[i]);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Serialize the filter
+     *
+     * The format is a header of the magic `AWBF`, a 32-bit version, the number of hashes,
+     * 4 reserved bytes and a 64-bit block count, followed by all block words. Every integer
+     * is little-endian, so the bytes can be shared between machines.
+     */
+    [[nodiscard]] std::vector<char> serialize() const {
+        std::vector<char> out;
+        out.reserve(header_size_ + blocks_.size() * sizeof(block));
+        out.insert(out.end(), magic_, magic_ + 4);
+        put_u32(out, version_);
+        put_u32(out, num_hashes_);
+        put_u32(out, 0);
+        put_u64(out, blocks_.size());
+        for (const auto& blk: blocks_) {
+            for (auto word: blk.words) {
+                put_u64(out, word);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Reconstruct a filter from the output of `serialize()`
+     *
+     * @note Throws `std::invalid_argument` if `bytes` is not a valid serialized filter.
+     */
+    [[nodiscard]] static blocked_bloom_filter deserialize(string_view bytes) {
+        if (bytes.size() < header_size_ || bytes.substr(0, 4) != string_view(magic_, 4)) {
+            throw std::invalid_argument("Not a serialized blocked_bloom_filter");
+        }
+        const char* data = bytes.data();
+        if (get_le(data + 4, 4) != version_) {
+            throw std::invalid_argument("Unsupported blocked_bloom_filter version");
+        }
+        const auto num_hashes = get_le(data + 8, 4);
+        const auto num_blocks = get_le(data + 16, 8);
+        if (num_hashes == 0 || num_hashes > 16 || num_blocks == 0 || num_blocks > (std::uint64_t(1) << 32)
+            || num_blocks != (bytes.size() - header_size_) / sizeof(block)
+            || (bytes.size() - header_size_) % sizeof(block) != 0) {
+            throw std::invalid_argument("Corrupt blocked_bloom_filter");
+        }
+        blocked_bloom_filter retval(static_cast<size_type>(num_blocks), static_cast<unsigned>(num_hashes), 0);
+        data += header_size_;
+        for (auto& blk: retval.blocks_) {
+            for (auto& word: blk.words) {
+                word = get_le(data, 8);
+                data += 8;
+            }
+        }
+        return retval;
+    }
+};
+}// namespace andwass
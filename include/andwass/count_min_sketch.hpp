@@ -0,0 +1,126 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace andwass {
+/**
+ * @brief Estimate how often strings occur in a stream in fixed memory
+ *
+ * The sketch is `depth()` rows of `width()` counters. A string increments one counter per
+ * row, and its estimate is the smallest of those counters. Estimates never undercount, and
+ * with probability `1 - e^-depth` overcount by at most `e / width` times `total()`.
+ *
+ * All row positions are derived from a single library `hash` of the string. Sketches with
+ * the same dimensions can be merged, e.g. after counting on several threads.
+ */
+class count_min_sketch {
+public:
+    using size_type = std::size_t;
+    using count_type = std::uint64_t;
+
+private:
+    size_type width_;
+    size_type depth_;
+    std::vector<count_type> counters_;
+    count_type total_ = 0;
+
+    [[nodiscard]] size_type column(std::uint64_t hash, size_type row) const noexcept {
+        // Double hashing, mapped onto [0, width) by multiply-shift instead of a division.
+        const auto h = static_cast<std::uint32_t>(hash) + static_cast<std::uint32_t>(row) * static_cast<std::uint32_t>((hash >> 32) | 1);
+        return static_cast<size_type>((std::uint64_t(h) * width_) >> 32);
+    }
+
+public:
+    /**
+     * @brief Construct an empty sketch
+     * @param width Counters per row, at most `2^32`.
+     * @param depth Number of rows.
+     *
+     * @note Throws `std::invalid_argument` if `width` or `depth` is 0 or `width` is too large,
+     * and `std::length_error` if `width * depth` counters can not be stored.
+     */
+    count_min_sketch(size_type width, size_type depth): width_(width), depth_(depth) {
+        if (width == 0 || depth == 0 || std::uint64_t(width) > (std::uint64_t(1) << 32)) {
+            throw std::invalid_argument("Invalid count_min_sketch dimensions");
+        }
+        if (depth > counters_.max_size() / width) {
+            throw std::length_error("count_min_sketch dimensions too large");
+        }
+        counters_.assign(width * depth, 0);
+    }
+
+    [[nodiscard]] size_type width() const noexcept {
+        return width_;
+    }
+
+    [[nodiscard]] size_type depth() const noexcept {
+        return depth_;
+    }
+
+    /**
+     * @brief Get the sum of all counts inserted
+     */
+    [[nodiscard]] count_type total() const noexcept {
+        return total_;
+    }
+
+    void clear() noexcept {
+        std::fill(counters_.begin(), counters_.end(), 0);
+        total_ = 0;
+    }
+
+    /**
+     * @brief Count `count` occurrences of `str`
+     */
+    void insert(string_view str, count_type count = 1) noexcept {
+        const auto hash = andwass::hash(str);
+        auto* row = counters_.data();
+        for (size_type i = 0; i < depth_; ++i, row += width_) {
+            row[column(hash, i)] += count;
+        }
+        total_ += count;
+    }
+
+    /**
+     * @brief Estimate the number of occurrences of `str`
+     * @return A count that is never less than the true count.
+     */
+    [[nodiscard]] count_type estimate(string_view str) const noexcept {
+        const auto hash = andwass::hash(str);
+        auto retval = (std::numeric_limits<count_type>::max)();
+        const auto* row = counters_.data();
+        for (size_type i = 0; i < depth_; ++i, row += width_) {
+            retval = (std::min)(retval, row[column(hash, i)]);
+        }
+        return retval;
+    }
+
+    /**
+     * @brief Add the counts of `other` to this sketch
+     *
+     * @note Throws `std::invalid_argument` if the dimensions differ.
+     */
+    void merge(const count_min_sketch& other) {
+        if (other.width_ != width_ || other.depth_ != depth_) {
+            throw std::invalid_argument("Cannot merge count_min_sketch of different dimensions");
+        }
+        auto* dest = counters_.data();
+        const auto* src = other.counters_.data();
+        for (size_type i = 0; i < counters_.size(); ++i) {
+            dest[i] += src[i];
+        }
+        total_ += other.total_;
+    }
+};
+}// namespace andwass
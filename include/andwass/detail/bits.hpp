@@ -0,0 +1,70 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <cstdint>
+
+namespace andwass {
+namespace detail
+{
+/**
+ * @brief Number of trailing zero bits, `x` must not be 0.
+ */
+inline int countr_zero(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * @brief Number of leading zero bits, `x` must not be 0.
+ */
+inline int countl_zero(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while ((x & (std::uint64_t(1) << 63)) == 0) {
+        x <<= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * @brief Number of set bits.
+ */
+inline int popcount(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<int>((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/**
+ * @brief Hint that the cache line at `ptr` will be read soon.
+ */
+inline void prefetch(const void* ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(ptr);
+#else
+    (void)ptr;
+#endif
+}
+}
+}// namespace andwass
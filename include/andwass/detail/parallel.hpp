@@ -0,0 +1,57 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace andwass {
+namespace detail
+{
+/**
+ * @brief Call `f(t)` for every `t` in `[0, num_threads)` concurrently, the calling thread runs `f(0)`.
+ *
+ * The first exception thrown by any call is rethrown once all threads have finished. If a
+ * thread can not be started the threads already running are joined and the error rethrown.
+ */
+template<class F>
+void run_parallel(unsigned num_threads, F&& f) {
+    std::vector<std::exception_ptr> errors(num_threads);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    auto guarded = [&](unsigned t) {
+        try {
+            f(t);
+        }
+        catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    try {
+        for (unsigned t = 1; t < num_threads; ++t) {
+            threads.emplace_back(guarded, t);
+        }
+    }
+    catch (...) {
+        // Threads already started use `f` and `errors`, they must finish before those go away.
+        for (auto& thread: threads) {
+            thread.join();
+        }
+        throw;
+    }
+    guarded(0);
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    for (auto& error: errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+}
+}// namespace andwass
@@ -0,0 +1,136 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace andwass {
+namespace detail
+{
+/**
+ * @brief Advance one 64-row block of the bit-parallel edit distance matrix by one column.
+ * @param pv, mv Positive and negative vertical deltas of the block, updated in place.
+ * @param eq Bits set for the rows whose pattern char equals the current text char.
+ * @param hin Horizontal delta entering the top row of the block, -1, 0 or 1.
+ * @param out_bit The row whose horizontal delta is returned.
+ * @return The horizontal delta leaving the block at `out_bit`.
+ *
+ * Myers' algorithm with Hyyrö's formulation for computing blocks of the matrix.
+ */
+inline int myers_advance_block(std::uint64_t& pv, std::uint64_t& mv, std::uint64_t eq, int hin, std::uint64_t out_bit) noexcept {
+    const auto xv = eq | mv;
+    if (hin < 0) {
+        eq |= 1;
+    }
+    const auto xh = (((eq & pv) + pv) ^ pv) | eq;
+    auto ph = mv | ~(xh | pv);
+    auto mh = pv & xh;
+    const int hout = (ph & out_bit) ? 1 : ((mh & out_bit) ? -1 : 0);
+    ph <<= 1;
+    mh <<= 1;
+    if (hin < 0) {
+        mh |= 1;
+    }
+    else if (hin > 0) {
+        ph |= 1;
+    }
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return hout;
+}
+}
+
+/**
+ * @brief Compute the Levenshtein distance between two views
+ * @param a, b The views to compare
+ * @param max_k The largest distance of interest.
+ * @return The number of single-char insertions, deletions and substitutions needed to turn
+ * `a` into `b`, or `string_view::npos` if that number is larger than `max_k`.
+ *
+ * Common prefixes and suffixes are stripped first. The remaining matrix is computed with
+ * the bit-parallel algorithm by Myers and Hyyrö, 64 rows per machine word and blocks of
+ * words for longer strings, so the cost is `O(ceil(m/64) * n)` rather than `O(m * n)`. The
+ * computation stops as soon as the distance is known to exceed `max_k`.
+ */
+[[nodiscard]] inline std::size_t edit_distance(string_view a, string_view b, std::size_t max_k = string_view::npos) {
+    while (!a.is_empty() && !b.is_empty() && a.front() == b.front()) {
+        a.remove_prefix(1);
+        b.remove_prefix(1);
+    }
+    while (!a.is_empty() && !b.is_empty() && a.back() == b.back()) {
+        a.remove_suffix(1);
+        b.remove_suffix(1);
+    }
+    // The shorter view is the pattern, it determines the number of blocks.
+    if (a.size() > b.size()) {
+        std::swap(a, b);
+    }
+    const auto pattern = a;
+    const auto text = b;
+    if (text.size() - pattern.size() > max_k) {
+        return string_view::npos;
+    }
+    if (pattern.is_empty()) {
+        return text.size();
+    }
+
+    const auto m = pattern.size();
+    const auto n = text.size();
+    const auto num_blocks = (m + 63) / 64;
+    const std::uint64_t last_bit = std::uint64_t(1) << ((m - 1) % 64);
+    std::size_t score = m;
+
+    // The score can change by at most one per remaining column.
+    auto exceeds = [&](std::size_t column) {
+        const auto remaining = n - column - 1;
+        return score > remaining && score - remaining > max_k;
+    };
+
+    if (num_blocks == 1) {
+        std::array<std::uint64_t, 256> peq{};
+        for (std::size_t i = 0; i < m; i++) {
+            peq[static_cast<unsigned char>(pattern[i])] |= std::uint64_t(1) << i;
+        }
+        std::uint64_t pv = ~std::uint64_t(0);
+        std::uint64_t mv = 0;
+        for (std::size_t j = 0; j < n; j++) {
+            const auto eq = peq[static_cast<unsigned char>(text[j])];
+            score += static_cast<std::size_t>(detail::myers_advance_block(pv, mv, eq, 1, last_bit));
+            if (exceeds(j)) {
+                return string_view::npos;
+            }
+        }
+    }
+    else {
+        std::vector<std::uint64_t> peq(num_blocks * 256, 0);
+        for (std::size_t i = 0; i < m; i++) {
+            peq[(i / 64) * 256 + static_cast<unsigned char>(pattern[i])] |= std::uint64_t(1) << (i % 64);
+        }
+        std::vector<std::uint64_t> pv(num_blocks, ~std::uint64_t(0));
+        std::vector<std::uint64_t> mv(num_blocks, 0);
+        const std::uint64_t high_bit = std::uint64_t(1) << 63;
+        for (std::size_t j = 0; j < n; j++) {
+            const auto ch = static_cast<unsigned char>(text[j]);
+            // Row 0 of the matrix is 0, 1, 2, ... so the top block always receives +1.
+            int carry = 1;
+            for (std::size_t block = 0; block < num_blocks; block++) {
+                const auto out_bit = block + 1 == num_blocks ? last_bit : high_bit;
+                carry = detail::myers_advance_block(pv[block], mv[block], peq[block * 256 + ch], carry, out_bit);
+            }
+            score += static_cast<std::size_t>(carry);
+            if (exceeds(j)) {
+                return string_view::npos;
+            }
+        }
+    }
+    return score <= max_k ? score : string_view::npos;
+}
+}// namespace andwass
@@ -0,0 +1,214 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace andwass {
+/**
+ * @brief A token-shape pattern compiled at compile time
+ *
+ * Supported syntax: literal chars, `.` (any char but `'\n'`), classes such as `[a-z_]` and `[^0-9]`,
+ * the escapes `\d \w \s \D \W \S \n \t \r` and escaped metacharacters, each optionally followed by
+ * one of the quantifiers `*`, `+` or `?`. Groups and alternation are not supported, use
+ * `andwass::regex` for those. At most 63 atoms are allowed.
+ *
+ * The pattern is parsed by a `constexpr` constructor into a table with one bit per atom
+ * for every char, and matching simulates the NFA with shifts and masks on a single
+ * 64-bit word (shift-and). When declared `constexpr` the table is a compile-time constant,
+ * no automaton is built at runtime, and malformed patterns fail to compile:
+ * ```c++
+ * constexpr andwass::fixed_pattern version("v\\d+\\.\\d+");
+ * static_assert(version.match("v1.22"));
+ * ```
+ */
+template<std::size_t N>
+class fixed_pattern {
+    // Bit `i` of `char_masks_[c]` is set if atom `i` accepts `c`. Bit `atoms_` is the accepting state.
+    std::uint64_t char_masks_[256] = {};
+    std::uint64_t loop_mask_ = 0;
+    std::uint64_t skip_mask_ = 0;
+    std::uint64_t start_ = 0;
+    std::size_t atoms_ = 0;
+
+    static constexpr bool in_escape_class(char escape, unsigned char ch) noexcept {
+        const bool digit = ch >= '0' && ch <= '9';
+        switch (escape) {
+        case 'd': case 'D': return digit != (escape == 'D');
+        case 'w': case 'W': return (digit || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_') != (escape == 'W');
+        case 's': case 'S': return (ch == ' ' || (ch >= '\t' && ch <= '\r')) != (escape == 'S');
+        case 'n': return ch == '\n';
+        case 't': return ch == '\t';
+        case 'r': return ch == '\r';
+        default: return static_cast<unsigned char>(escape) == ch;
+        }
+    }
+
+    constexpr void add_range(std::uint64_t bit, unsigned lo, unsigned hi) noexcept {
+        for (auto c = lo; c <= hi; c++) {
+            char_masks_[c] |= bit;
+        }
+    }
+
+    constexpr void add_escape(std::uint64_t bit, char escape) noexcept {
+        for (unsigned c = 0; c < 256; c++) {
+            if (in_escape_class(escape, static_cast<unsigned char>(c))) {
+                char_masks_[c] |= bit;
+            }
+        }
+    }
+
+    constexpr std::size_t parse_class(string_view pattern, std::size_t pos, std::uint64_t bit) {
+        std::uint64_t set[256] = {};
+        const bool negate = pos < pattern.size() && pattern[pos] == '^';
+        if (negate) {
+            ++pos;
+        }
+        // A ']' directly after the opening bracket is part of the class.
+        for (bool first = true; pos < pattern.size() && (first || pattern[pos] != ']'); first = false) {
+            auto lo = static_cast<unsigned char>(pattern[pos++]);
+            if (lo == '\\' && pos < pattern.size()) {
+                const auto escape = pattern[pos++];
+                for (unsigned c = 0; c < 256; c++) {
+                    set[c] |= in_escape_class(escape, static_cast<unsigned char>(c)) ? 1 : 0;
+                }
+                continue;
+            }
+            if (pos + 1 < pattern.size() && pattern[pos] == '-' && pattern[pos + 1] != ']') {
+                const auto hi = static_cast<unsigned char>(pattern[pos + 1]);
+                if (hi < lo) {
+                    throw std::invalid_argument("Invalid range in pattern character class");
+                }
+                for (unsigned c = lo; c <= hi; c++) {
+                    set[c] = 1;
+                }
+                pos += 2;
+            }
+            else {
+                set[lo] = 1;
+            }
+        }
+        if (pos >= pattern.size()) {
+            throw std::invalid_argument("Missing ']' in pattern");
+        }
+        for (unsigned c = 0; c < 256; c++) {
+            if ((set[c] != 0) != negate) {
+                char_masks_[c] |= bit;
+            }
+        }
+        return pos + 1;
+    }
+
+    [[nodiscard]] constexpr std::uint64_t closure(std::uint64_t states) const noexcept {
+        // Skippable atoms (`x*`, `x?`) let the state advance without consuming a char.
+        for (auto next = states | ((states & skip_mask_) << 1); next != states; next = states | ((states & skip_mask_) << 1)) {
+            states = next;
+        }
+        return states;
+    }
+
+    [[nodiscard]] constexpr std::uint64_t step(std::uint64_t states, char ch) const noexcept {
+        const auto consumed = states & char_masks_[static_cast<unsigned char>(ch)];
+        // `x*` and `x+` may consume again from the same atom.
+        return closure((consumed << 1) | (consumed & loop_mask_));
+    }
+
+    [[nodiscard]] constexpr bool accepts(std::uint64_t states) const noexcept {
+        return (states >> atoms_) & 1;
+    }
+
+public:
+    /**
+     * @brief Compile a pattern
+     * @param pattern A NULL-terminated pattern, typically a string literal.
+     *
+     * @note Throws `std::invalid_argument` for malformed patterns and `std::length_error` for
+     * patterns with more than 63 atoms. In a constant expression both are compile errors.
+     */
+    constexpr fixed_pattern(const char (&pattern)[N]) {
+        const string_view source(pattern, N - 1);
+        std::size_t pos = 0;
+        while (pos < source.size()) {
+            if (atoms_ == 63) {
+                throw std::length_error("Too many atoms in pattern");
+            }
+            const std::uint64_t bit = std::uint64_t(1) << atoms_;
+            const auto ch = source[pos++];
+            switch (ch) {
+            case '.':
+                add_range(bit, 0, '\n' - 1);
+                add_range(bit, '\n' + 1, 255);
+                break;
+            case '[':
+                pos = parse_class(source, pos, bit);
+                break;
+            case '\\':
+                if (pos == source.size()) {
+                    throw std::invalid_argument("Unexpected end of pattern");
+                }
+                add_escape(bit, source[pos++]);
+                break;
+            case '*': case '+': case '?':
+                throw std::invalid_argument("Nothing to repeat in pattern");
+            case '(': case ')': case '|': case '^': case '$':
+                throw std::invalid_argument("Unsupported metacharacter in pattern");
+            default:
+                char_masks_[static_cast<unsigned char>(ch)] |= bit;
+                break;
+            }
+            if (pos < source.size() && (source[pos] == '*' || source[pos] == '+' || source[pos] == '?')) {
+                const auto quantifier = source[pos++];
+                loop_mask_ |= quantifier != '?' ? bit : 0;
+                skip_mask_ |= quantifier != '+' ? bit : 0;
+            }
+            ++atoms_;
+        }
+        start_ = closure(1);
+    }
+
+    /**
+     * @brief Check if the whole text matches the pattern
+     * @param text The text to match
+     * @return True if all of `text` matches.
+     */
+    [[nodiscard]] constexpr bool match(string_view text) const noexcept {
+        auto states = start_;
+        for (std::size_t i = 0; i < text.size(); i++) {
+            states = step(states, text[i]);
+            if (states == 0) {
+                return false;
+            }
+        }
+        return accepts(states);
+    }
+
+    /**
+     * @brief Check if any part of the text matches the pattern
+     * @param text The text to search
+     * @return True if some substring of `text` matches.
+     */
+    [[nodiscard]] constexpr bool search(string_view text) const noexcept {
+        auto states = start_;
+        for (std::size_t i = 0; i < text.size(); i++) {
+            if (accepts(states)) {
+                return true;
+            }
+            states = step(states, text[i]) | start_;
+        }
+        return accepts(states);
+    }
+
+    /**
+     * @brief Get the number of atoms in the pattern
+     */
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return atoms_;
+    }
+};
+}// namespace andwass
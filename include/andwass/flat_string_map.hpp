@@ -0,0 +1,505 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/prefixed_view.hpp>
+#include <andwass/string_view.hpp>
+#include <andwass/detail/bits.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace andwass {
+namespace detail
+{
+/**
+ * @brief Append-only storage for key bytes, handed out views never move.
+ */
+class string_arena {
+    static constexpr std::size_t block_size = 16 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* current_ = nullptr;
+    std::size_t remaining_ = 0;
+
+public:
+    string_arena() = default;
+
+    string_arena(string_arena&& rhs) noexcept
+        : blocks_(std::move(rhs.blocks_)), current_(std::exchange(rhs.current_, nullptr)), remaining_(std::exchange(rhs.remaining_, 0)) {}
+
+    string_arena& operator=(string_arena&& rhs) noexcept {
+        if (this != &rhs) {
+            blocks_ = std::move(rhs.blocks_);
+            current_ = std::exchange(rhs.current_, nullptr);
+            remaining_ = std::exchange(rhs.remaining_, 0);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Copy `str` into the arena
+     * @return A view of the copy, valid until `clear()` or destruction.
+     */
+    string_view store(string_view str) {
+        if (str.is_empty()) {
+            return str;
+        }
+        if (str.size() > block_size) {
+            // Oversized strings get a block of their own, the current block keeps being filled.
+            blocks_.emplace_back(new char[str.size()]);
+            std::memcpy(blocks_.back().get(), str.data(), str.size());
+            return string_view(blocks_.back().get(), str.size());
+        }
+        if (str.size() > remaining_) {
+            blocks_.emplace_back(new char[block_size]);
+            current_ = blocks_.back().get();
+            remaining_ = block_size;
+        }
+        char* dest = current_;
+        std::memcpy(dest, str.data(), str.size());
+        current_ += str.size();
+        remaining_ -= str.size();
+        return string_view(dest, str.size());
+    }
+
+    void clear() noexcept {
+        blocks_.clear();
+        current_ = nullptr;
+        remaining_ = 0;
+    }
+};
+
+/**
+ * @brief A group of 8 control bytes probed together as one word
+ *
+ * A control byte is `0x80` for an empty slot, `0xFE` for an erased slot, or the 7-bit
+ * hash fingerprint of the key in a full slot. Match results are masks with the high bit
+ * of every matching byte set.
+ */
+struct control_group {
+    static constexpr std::size_t width = 8;
+    static constexpr unsigned char empty = 0x80;
+    static constexpr unsigned char deleted = 0xFE;
+
+    static constexpr std::uint64_t lsbs = 0x0101010101010101ull;
+    static constexpr std::uint64_t msbs = 0x8080808080808080ull;
+
+    std::uint64_t ctrl;
+
+    explicit control_group(const unsigned char* pos) noexcept {
+        std::memcpy(&ctrl, pos, sizeof(ctrl));
+    }
+
+    /**
+     * @brief Bytes equal to the fingerprint `h2`
+     *
+     * May report a false positive in the byte following a true match, which is harmless
+     * since every candidate is verified against the key.
+     */
+    [[nodiscard]] std::uint64_t match(unsigned char h2) const noexcept {
+        const auto x = ctrl ^ (lsbs * h2);
+        return (x - lsbs) & ~x & msbs;
+    }
+
+    [[nodiscard]] std::uint64_t match_empty() const noexcept {
+        return ctrl & ~(ctrl << 6) & msbs;
+    }
+
+    [[nodiscard]] std::uint64_t match_empty_or_deleted() const noexcept {
+        return ctrl & msbs;
+    }
+
+    [[nodiscard]] static std::size_t first_index(std::uint64_t mask) noexcept {
+        return static_cast<std::size_t>(countr_zero(mask)) / 8;
+    }
+};
+}// namespace detail
+
+/**
+ * @brief An unordered map from strings to `V` using open addressing in the style of SwissTable
+ *
+ * Slots are split into groups of 8, each with a word of control bytes holding a 7-bit
+ * fingerprint of the key hash. A lookup compares all fingerprints of a group in a few
+ * word operations (SWAR), and candidate keys are stored as `prefixed_view` so most
+ * remaining mismatches are rejected by comparing size and prefix inline, without
+ * touching the key bytes.
+ *
+ * Keys longer than 12 chars are copied into an arena owned by the map. Erasing a key does
+ * not release its arena bytes until `clear()`.
+ *
+ * Pointers to values are invalidated by any insertion that grows the table.
+ */
+template<class V>
+class flat_string_map {
+public:
+    using size_type = std::size_t;
+    using mapped_type = V;
+
+private:
+    using group = detail::control_group;
+
+    struct slot {
+        prefixed_view key;
+        V value;
+
+        template<class... Args>
+        explicit slot(prefixed_view k, Args&&... args): key(k), value(std::forward<Args>(args)...) {}
+    };
+
+    using slot_storage = std::aligned_storage_t<sizeof(slot), alignof(slot)>;
+
+    std::unique_ptr<unsigned char[]> ctrl_;
+    std::unique_ptr<slot_storage[]> slots_;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+    size_type growth_left_ = 0;
+    detail::string_arena arena_;
+
+    [[nodiscard]] slot* slot_at(size_type i) const noexcept {
+        return std::launder(reinterpret_cast<slot*>(&slots_[i]));
+    }
+
+    [[nodiscard]] size_type num_groups() const noexcept {
+        return capacity_ / group::width;
+    }
+
+    [[nodiscard]] static size_type max_load(size_type capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    [[nodiscard]] static std::uint64_t hash_key(string_view key) noexcept {
+        return andwass::hash(key);
+    }
+
+    [[nodiscard]] static unsigned char h2(std::uint64_t hash) noexcept {
+        return static_cast<unsigned char>(hash & 0x7F);
+    }
+
+    /**
+     * @brief Visit groups of a table with `capacity` slots in triangular order, which covers
+     * every group of a power of two table.
+     */
+    template<class F>
+    static size_type probe(size_type capacity, std::uint64_t hash, F&& f) noexcept {
+        const auto mask = capacity / group::width - 1;
+        auto g = static_cast<size_type>(hash >> 7) & mask;
+        for (size_type step = 1;; ++step) {
+            const auto result = f(g * group::width);
+            if (result != static_cast<size_type>(-1)) {
+                return result;
+            }
+            g = (g + step) & mask;
+        }
+    }
+
+    [[nodiscard]] size_type find_index(const prefixed_view& key, std::uint64_t hash) const noexcept {
+        if (capacity_ == 0) {
+            return capacity_;
+        }
+        const auto fingerprint = h2(hash);
+        return probe(capacity_, hash, [&](size_type base) -> size_type {
+            const group g(ctrl_.get() + base);
+            for (auto m = g.match(fingerprint); m != 0; m &= m - 1) {
+                const auto i = base + group::first_index(m);
+                if (slot_at(i)->key == key) {
+                    return i;
+                }
+            }
+            if (g.match_empty() != 0) {
+                return capacity_;
+            }
+            return static_cast<size_type>(-1);
+        });
+    }
+
+    [[nodiscard]] static size_type find_free(const unsigned char* ctrl, size_type capacity, std::uint64_t hash) noexcept {
+        return probe(capacity, hash, [&](size_type base) -> size_type {
+            const group g(ctrl + base);
+            if (const auto m = g.match_empty_or_deleted(); m != 0) {
+                return base + group::first_index(m);
+            }
+            return static_cast<size_type>(-1);
+        });
+    }
+
+    [[nodiscard]] size_type find_free(std::uint64_t hash) const noexcept {
+        return find_free(ctrl_.get(), capacity_, hash);
+    }
+
+    void destroy_slots() noexcept {
+        for (size_type i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] < 0x80) {
+                slot_at(i)->~slot();
+            }
+        }
+    }
+
+    /**
+     * @brief Move every key into a new table of `new_capacity` slots
+     *
+     * The new table is built on the side and only replaces the current one once every
+     * value is in place. Values are copied rather than moved if their move constructor may
+     * throw, so if copying throws the map is left unchanged.
+     */
+    void rehash(size_type new_capacity) {
+        std::unique_ptr<unsigned char[]> new_ctrl(new unsigned char[new_capacity]);
+        std::fill_n(new_ctrl.get(), new_capacity, group::empty);
+        std::unique_ptr<slot_storage[]> new_slots(new slot_storage[new_capacity]);
+
+        try {
+            for (size_type i = 0; i < capacity_; ++i) {
+                if (ctrl_[i] < 0x80) {
+                    auto* old = slot_at(i);
+                    const auto hash = hash_key(old->key.view());
+                    const auto dest = find_free(new_ctrl.get(), new_capacity, hash);
+                    new (&new_slots[dest]) slot(old->key, std::move_if_noexcept(old->value));
+                    new_ctrl[dest] = h2(hash);
+                }
+            }
+        }
+        catch (...) {
+            for (size_type j = 0; j < new_capacity; ++j) {
+                if (new_ctrl[j] < 0x80) {
+                    std::launder(reinterpret_cast<slot*>(&new_slots[j]))->~slot();
+                }
+            }
+            throw;
+        }
+
+        destroy_slots();
+        ctrl_ = std::move(new_ctrl);
+        slots_ = std::move(new_slots);
+        capacity_ = new_capacity;
+        growth_left_ = max_load(new_capacity) - size_;
+    }
+
+    void grow_if_needed() {
+        if (growth_left_ > 0) {
+            return;
+        }
+        if (capacity_ == 0) {
+            rehash(group::width * 2);
+        }
+        else if (size_ * 2 <= max_load(capacity_)) {
+            // Mostly erased slots, rehash in place to reclaim them.
+            rehash(capacity_);
+        }
+        else {
+            rehash(capacity_ * 2);
+        }
+    }
+
+    template<class... Args>
+    std::pair<slot*, bool> emplace_impl(string_view key, std::uint64_t hash, Args&&... args) {
+        const prefixed_view probe_key(key);
+        if (const auto i = find_index(probe_key, hash); i != capacity_) {
+            return {slot_at(i), false};
+        }
+        grow_if_needed();
+        const auto i = find_free(hash);
+        const prefixed_view stored = probe_key.is_inline() ? probe_key : prefixed_view(arena_.store(key));
+        new (&slots_[i]) slot(stored, std::forward<Args>(args)...);
+        // Reusing an erased slot does not consume growth.
+        if (ctrl_[i] == group::empty) {
+            --growth_left_;
+        }
+        ctrl_[i] = h2(hash);
+        ++size_;
+        return {slot_at(i), true};
+    }
+
+    [[nodiscard]] slot* find_slot(string_view key) const noexcept {
+        if (key.size() > (std::numeric_limits<std::uint32_t>::max)()) {
+            return nullptr;
+        }
+        const auto i = find_index(prefixed_view(key), hash_key(key));
+        return i == capacity_ ? nullptr : slot_at(i);
+    }
+
+public:
+    flat_string_map() = default;
+
+    flat_string_map(const flat_string_map&) = delete;
+    flat_string_map& operator=(const flat_string_map&) = delete;
+
+    flat_string_map(flat_string_map&& rhs) noexcept
+        : ctrl_(std::move(rhs.ctrl_)), slots_(std::move(rhs.slots_)), capacity_(std::exchange(rhs.capacity_, 0)),
+          size_(std::exchange(rhs.size_, 0)), growth_left_(std::exchange(rhs.growth_left_, 0)), arena_(std::move(rhs.arena_)) {}
+
+    flat_string_map& operator=(flat_string_map&& rhs) noexcept {
+        if (this != &rhs) {
+            destroy_slots();
+            ctrl_ = std::move(rhs.ctrl_);
+            slots_ = std::move(rhs.slots_);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+            size_ = std::exchange(rhs.size_, 0);
+            growth_left_ = std::exchange(rhs.growth_left_, 0);
+            arena_ = std::move(rhs.arena_);
+        }
+        return *this;
+    }
+
+    ~flat_string_map() {
+        destroy_slots();
+    }
+
+    /**
+     * @brief Get the number of keys in the map
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] bool is_empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Get the number of slots, a power of two that is at least 16 once anything is inserted
+     */
+    [[nodiscard]] size_type capacity() const noexcept {
+        return capacity_;
+    }
+
+    /**
+     * @brief Remove all keys, keeping the slots allocated
+     */
+    void clear() noexcept {
+        destroy_slots();
+        if (capacity_ != 0) {
+            std::fill_n(ctrl_.get(), capacity_, group::empty);
+        }
+        size_ = 0;
+        growth_left_ = max_load(capacity_);
+        arena_.clear();
+    }
+
+    /**
+     * @brief Make room for at least `count` keys without growing
+     *
+     * @note Throws `std::length_error` if the slots for `count` keys can not be addressed.
+     */
+    void reserve(size_type count) {
+        constexpr auto max_capacity = (std::numeric_limits<size_type>::max)() / sizeof(slot_storage);
+        size_type new_capacity = group::width * 2;
+        while (max_load(new_capacity) < count) {
+            if (new_capacity > max_capacity / 2) {
+                throw std::length_error("flat_string_map::reserve count too large");
+            }
+            new_capacity *= 2;
+        }
+        if (new_capacity > capacity_) {
+            rehash(new_capacity);
+        }
+    }
+
+    /**
+     * @brief Insert a key if it is not already present
+     * @param key The key, copied into the map if longer than 12 chars.
+     * @param args Arguments to construct the value with, only used if the key is inserted.
+     * @return A pointer to the value of `key`, and true if it was inserted.
+     *
+     * @note Throws `std::length_error` if `key` is longer than `2^32 - 1` chars.
+     */
+    template<class... Args>
+    std::pair<V*, bool> try_emplace(string_view key, Args&&... args) {
+        auto retval = emplace_impl(key, hash_key(key), std::forward<Args>(args)...);
+        return {&retval.first->value, retval.second};
+    }
+
+    /**
+     * @brief As `try_emplace`, with the hash of `key` already computed
+     * @param hash Must be `andwass::hash(key)`.
+     */
+    template<class... Args>
+    std::pair<V*, bool> try_emplace_hashed(string_view key, std::uint64_t hash, Args&&... args) {
+        auto retval = emplace_impl(key, hash, std::forward<Args>(args)...);
+        return {&retval.first->value, retval.second};
+    }
+
+    /**
+     * @brief Get the value of a key, inserting a default constructed value if missing
+     */
+    V& operator[](string_view key) {
+        return emplace_impl(key, hash_key(key)).first->value;
+    }
+
+    /**
+     * @brief Find the value of a key
+     * @return A pointer to the value, or `nullptr` if `key` is not in the map.
+     */
+    [[nodiscard]] V* find(string_view key) noexcept {
+        auto* s = find_slot(key);
+        return s ? &s->value : nullptr;
+    }
+
+    [[nodiscard]] const V* find(string_view key) const noexcept {
+        const auto* s = find_slot(key);
+        return s ? &s->value : nullptr;
+    }
+
+    [[nodiscard]] bool contains(string_view key) const noexcept {
+        return find_slot(key) != nullptr;
+    }
+
+    /**
+     * @brief Remove a key
+     * @return true if `key` was in the map.
+     */
+    bool erase(string_view key) noexcept {
+        auto* s = find_slot(key);
+        if (!s) {
+            return false;
+        }
+        const auto i = static_cast<size_type>(reinterpret_cast<slot_storage*>(s) - slots_.get());
+        s->~slot();
+        --size_;
+        // Probes only continue past a group without empty slots, so if this group has
+        // one no probe can depend on the erased slot and it can become empty again.
+        const auto base = i - i % group::width;
+        if (group(ctrl_.get() + base).match_empty() != 0) {
+            ctrl_[i] = group::empty;
+            ++growth_left_;
+        }
+        else {
+            ctrl_[i] = group::deleted;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Call `f(key, value)` for every key, in unspecified order
+     */
+    template<class F>
+    void for_each(F&& f) const {
+        for (size_type i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] < 0x80) {
+                const auto* s = slot_at(i);
+                f(s->key.view(), static_cast<const V&>(s->value));
+            }
+        }
+    }
+
+    template<class F>
+    void for_each(F&& f) {
+        for (size_type i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] < 0x80) {
+                auto* s = slot_at(i);
+                f(s->key.view(), s->value);
+            }
+        }
+    }
+};
+}// namespace andwass
@@ -0,0 +1,462 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+#include <andwass/suffix_array.hpp>
+#include <andwass/detail/bits.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace andwass {
+namespace detail
+{
+/**
+ * @brief Operations on a bit vector with rank support stored in a flat word array
+ *
+ * Bits are grouped in blocks of 512, each stored as 9 words: the number of set bits before
+ * the block followed by the 8 words of bits. A rank query reads a single block.
+ */
+struct rank_bits {
+    static constexpr std::size_t block_bits = 512;
+    static constexpr std::size_t block_words = 9;
+
+    /**
+     * @brief Words needed for `bits` bits, including room to ask for the rank of `bits`
+     */
+    [[nodiscard]] static std::size_t storage_words(std::size_t bits) noexcept {
+        return (bits / block_bits + 1) * block_words;
+    }
+
+    static void set(std::uint64_t* blocks, std::size_t i) noexcept {
+        blocks[(i / block_bits) * block_words + 1 + (i % block_bits) / 64] |= std::uint64_t(1) << (i % 64);
+    }
+
+    /**
+     * @brief Fill in the block counts once all bits are set
+     */
+    static void finalize(std::uint64_t* blocks, std::size_t bits) noexcept {
+        std::uint64_t count = 0;
+        for (std::size_t b = 0; b <= bits / block_bits; ++b) {
+            auto* block = blocks + b * block_words;
+            block[0] = count;
+            for (std::size_t w = 1; w < block_words; ++w) {
+                count += static_cast<std::uint64_t>(popcount(block[w]));
+            }
+        }
+    }
+
+    [[nodiscard]] static bool get(const std::uint64_t* blocks, std::size_t i) noexcept {
+        return (blocks[(i / block_bits) * block_words + 1 + (i % block_bits) / 64] >> (i % 64)) & 1;
+    }
+
+    /**
+     * @brief Number of set bits in `[0, i)`
+     */
+    [[nodiscard]] static std::size_t rank1(const std::uint64_t* blocks, std::size_t i) noexcept {
+        const auto* block = blocks + (i / block_bits) * block_words;
+        auto retval = static_cast<std::size_t>(block[0]);
+        const auto words = (i % block_bits) / 64;
+        for (std::size_t w = 0; w < words; ++w) {
+            retval += static_cast<std::size_t>(popcount(block[1 + w]));
+        }
+        if (const auto rest = i % 64; rest != 0) {
+            retval += static_cast<std::size_t>(popcount(block[1 + words] & ((std::uint64_t(1) << rest) - 1)));
+        }
+        return retval;
+    }
+};
+}// namespace detail
+
+/**
+ * @brief A compressed full-text index answering `count` and `locate` without the text
+ *
+ * The index stores the Burrows-Wheeler transform of the text in a wavelet matrix (8 rank
+ * bit vectors, about 1.1 bytes per text byte), the symbol counts, and every
+ * `sample_rate()`-th suffix array entry (`8 / sample_rate()` bytes per text byte). Counting
+ * a needle of length `m` takes O(m) rank queries, locating each occurrence takes at most
+ * `sample_rate()` additional steps.
+ *
+ * All data lives in one flat array of 64-bit words, in native byte order. `data()` can be
+ * written to a file as is, and `load()` creates an index over such words, e.g. from a
+ * memory mapped file, without copying or parsing them.
+ */
+class fm_index {
+public:
+    using size_type = std::size_t;
+
+private:
+    static constexpr std::uint64_t magic_ = 0x5844494d46575741ull; // "AWWFMIDX"
+    static constexpr std::uint64_t version_ = 1;
+    static constexpr size_type levels_ = 8;
+
+    // Header word indices
+    enum : size_type {
+        h_magic,
+        h_version,
+        h_text_size,
+        h_sentinel_row,
+        h_sample_rate,
+        h_num_samples,
+        header_size
+    };
+
+    struct layout {
+        size_type counts;       // 257 words: first row of every symbol, and the total
+        size_type bottom;       // 256 words: first last level position of every symbol
+        size_type zeros;        // 8 words: zero bits in every level
+        size_type levels;       // 8 bit vectors of `rows` bits
+        size_type level_words;
+        size_type sampled;      // bit vector marking rows with a sample
+        size_type samples;      // suffix array samples in row order
+        size_type total;
+
+        layout(size_type rows, size_type num_samples) noexcept {
+            counts = header_size;
+            bottom = counts + 257;
+            zeros = bottom + 256;
+            levels = zeros + levels_;
+            level_words = detail::rank_bits::storage_words(rows);
+            sampled = levels + levels_ * level_words;
+            samples = sampled + level_words;
+            total = samples + num_samples;
+        }
+    };
+
+    std::vector<std::uint64_t> storage_;
+    const std::uint64_t* data_ = nullptr;
+    size_type size_ = 0;
+    size_type rows_ = 0;
+    size_type sentinel_row_ = 0;
+    layout layout_{0, 0};
+
+    fm_index() = default;
+
+    void attach(const std::uint64_t* data, size_type size) noexcept {
+        data_ = data;
+        size_ = size;
+        rows_ = static_cast<size_type>(data[h_text_size]) + 1;
+        sentinel_row_ = static_cast<size_type>(data[h_sentinel_row]);
+        layout_ = layout(rows_, static_cast<size_type>(data[h_num_samples]));
+    }
+
+    [[nodiscard]] const std::uint64_t* level(size_type l) const noexcept {
+        return data_ + layout_.levels + l * layout_.level_words;
+    }
+
+    /**
+     * @brief Follow position `i` of symbol `c` down through all wavelet matrix levels
+     */
+    [[nodiscard]] size_type descend(unsigned char c, size_type i) const noexcept {
+        for (size_type l = 0; l < levels_; ++l) {
+            const auto ones = detail::rank_bits::rank1(level(l), i);
+            if ((c >> (levels_ - 1 - l)) & 1) {
+                i = static_cast<size_type>(data_[layout_.zeros + l]) + ones;
+            }
+            else {
+                i -= ones;
+            }
+        }
+        return i;
+    }
+
+    /**
+     * @brief Number of occurrences of `c` in the BWT rows `[0, i)`, not counting the sentinel
+     */
+    [[nodiscard]] size_type rank(unsigned char c, size_type i) const noexcept {
+        auto retval = descend(c, i) - static_cast<size_type>(data_[layout_.bottom + c]);
+        // The sentinel is stored as a 0 byte.
+        if (c == 0 && sentinel_row_ < i) {
+            --retval;
+        }
+        return retval;
+    }
+
+    /**
+     * @brief Map a row to the row of the suffix starting one position earlier
+     *
+     * Must not be called for the sentinel row.
+     */
+    [[nodiscard]] size_type last_to_first(size_type i) const noexcept {
+        const auto original = i;
+        unsigned c = 0;
+        for (size_type l = 0; l < levels_; ++l) {
+            const auto ones = detail::rank_bits::rank1(level(l), i);
+            const auto bit = detail::rank_bits::get(level(l), i);
+            c = (c << 1) | static_cast<unsigned>(bit);
+            if (bit) {
+                i = static_cast<size_type>(data_[layout_.zeros + l]) + ones;
+            }
+            else {
+                i -= ones;
+            }
+        }
+        auto r = i - static_cast<size_type>(data_[layout_.bottom + c]);
+        if (c == 0 && sentinel_row_ < original) {
+            --r;
+        }
+        return static_cast<size_type>(data_[layout_.counts + c]) + r;
+    }
+
+    [[nodiscard]] std::pair<size_type, size_type> row_range(string_view needle) const noexcept {
+        if (needle.is_empty()) {
+            // Every row except the one of the sentinel suffix.
+            return {1, rows_};
+        }
+        size_type first = 0;
+        size_type last = rows_;
+        for (auto i = needle.size(); i-- > 0 && first < last;) {
+            const auto c = static_cast<unsigned char>(needle[i]);
+            const auto start = static_cast<size_type>(data_[layout_.counts + c]);
+            first = start + rank(c, first);
+            last = start + rank(c, last);
+        }
+        return {first, (std::max)(first, last)};
+    }
+
+    /**
+     * @brief Check the symbol counts, level totals and sample count against the bit vectors
+     */
+    [[nodiscard]] bool has_consistent_totals() const noexcept {
+        const auto* counts = data_ + layout_.counts;
+        if (counts[0] != 1 || counts[256] != rows_) {
+            return false;
+        }
+        for (size_type c = 0; c < 256; ++c) {
+            if (counts[c + 1] < counts[c]) {
+                return false;
+            }
+        }
+        for (size_type l = 0; l < levels_; ++l) {
+            const auto ones = detail::rank_bits::rank1(level(l), rows_);
+            if (ones > rows_ || data_[layout_.zeros + l] != rows_ - ones) {
+                return false;
+            }
+        }
+        // As `descend(c, 0)`, but stopping at positions outside the rows.
+        for (unsigned c = 0; c < 256; ++c) {
+            size_type i = 0;
+            for (size_type l = 0; l < levels_; ++l) {
+                const auto ones = detail::rank_bits::rank1(level(l), i);
+                if (ones > i) {
+                    return false;
+                }
+                i = ((c >> (levels_ - 1 - l)) & 1) ? static_cast<size_type>(data_[layout_.zeros + l]) + ones : i - ones;
+                if (i > rows_) {
+                    return false;
+                }
+            }
+            if (data_[layout_.bottom + c] != i) {
+                return false;
+            }
+        }
+        return detail::rank_bits::rank1(data_ + layout_.sampled, rows_) == layout_.total - layout_.samples;
+    }
+
+public:
+    /**
+     * @brief Build the index of `text`
+     * @param text The text to index, it is not referenced after construction.
+     * @param sample_rate Store every `sample_rate`-th suffix array entry, trading `locate` speed for space.
+     *
+     * Building needs the full suffix array, `sizeof(size_type)` bytes per text byte, alongside
+     * the BWT, a byte per text byte, and the index being built. With 8 byte positions and
+     * the default sample rate that is a peak of about 10.5 bytes per text byte, more while
+     * sorting if LMS substrings are mostly distinct (see `suffix_array`).
+     *
+     * @note Throws `std::invalid_argument` if `sample_rate` is 0.
+     */
+    explicit fm_index(string_view text, size_type sample_rate = 32) {
+        if (sample_rate == 0) {
+            throw std::invalid_argument("fm_index sample_rate must not be 0");
+        }
+        const auto n = text.size();
+        const auto rows = n + 1;
+        const auto* bytes = reinterpret_cast<const unsigned char*>(text.data());
+
+        // Rows are the sorted suffixes of the text followed by a unique smallest sentinel,
+        // whose suffix is the empty one at `n` and sorts first.
+        std::vector<size_type> sa(rows);
+        sa[0] = n;
+        detail::sa_is(bytes, n, 255, sa.data() + 1);
+
+        size_type num_samples = 0;
+        for (auto pos: sa) {
+            num_samples += pos % sample_rate == 0;
+        }
+        const layout lay(rows, num_samples);
+        storage_.assign(lay.total, 0);
+        auto* data = storage_.data();
+        data[h_magic] = magic_;
+        data[h_version] = version_;
+        data[h_text_size] = n;
+        data[h_sample_rate] = sample_rate;
+        data[h_num_samples] = num_samples;
+
+        std::vector<unsigned char> bwt(rows);
+        size_type sample = 0;
+        for (size_type i = 0; i < rows; ++i) {
+            if (sa[i] == 0) {
+                data[h_sentinel_row] = i;
+                bwt[i] = 0;
+            }
+            else {
+                bwt[i] = bytes[sa[i] - 1];
+            }
+            if (sa[i] % sample_rate == 0) {
+                detail::rank_bits::set(data + lay.sampled, i);
+                data[lay.samples + sample++] = sa[i];
+            }
+        }
+        detail::rank_bits::finalize(data + lay.sampled, rows);
+        sa = std::vector<size_type>();
+
+        std::uint64_t symbol_counts[256] = {};
+        for (size_type i = 0; i < n; ++i) {
+            ++symbol_counts[bytes[i]];
+        }
+        std::uint64_t row = 1;
+        for (size_type c = 0; c < 256; ++c) {
+            data[lay.counts + c] = row;
+            row += symbol_counts[c];
+        }
+        data[lay.counts + 256] = row;
+
+        // Wavelet matrix: every level stably partitions the symbols by one bit, MSB first.
+        std::vector<unsigned char> next(rows);
+        for (size_type l = 0; l < levels_; ++l) {
+            auto* bits = data + lay.levels + l * lay.level_words;
+            const auto shift = levels_ - 1 - l;
+            size_type zeros = 0;
+            for (size_type i = 0; i < rows; ++i) {
+                if ((bwt[i] >> shift) & 1) {
+                    detail::rank_bits::set(bits, i);
+                }
+                else {
+                    ++zeros;
+                }
+            }
+            detail::rank_bits::finalize(bits, rows);
+            data[lay.zeros + l] = zeros;
+            size_type zero_pos = 0;
+            size_type one_pos = zeros;
+            for (size_type i = 0; i < rows; ++i) {
+                next[((bwt[i] >> shift) & 1) ? one_pos++ : zero_pos++] = bwt[i];
+            }
+            bwt.swap(next);
+        }
+        attach(storage_.data(), storage_.size());
+        // Equal symbols end up contiguous in the last level, starting where position 0 lands.
+        for (unsigned c = 0; c < 256; ++c) {
+            storage_[lay.bottom + c] = descend(static_cast<unsigned char>(c), 0);
+        }
+    }
+
+    fm_index(const fm_index&) = delete;
+    fm_index& operator=(const fm_index&) = delete;
+
+    fm_index(fm_index&&) noexcept = default;
+    fm_index& operator=(fm_index&&) noexcept = default;
+
+    /**
+     * @brief Create an index over words previously obtained from `data()`
+     * @param data The words, which are not copied and must outlive the index.
+     * @param size The number of words.
+     *
+     * The header and the per-symbol and per-level totals are checked against each other,
+     * which reads a constant number of words. The bits of the BWT and the suffix array
+     * samples are not scanned, so `load` trusts them: words modified inside them after
+     * passing the checks give wrong results and may make queries read out of bounds.
+     *
+     * @note Throws `std::invalid_argument` if the words are not a valid index of this version
+     * and byte order.
+     */
+    [[nodiscard]] static fm_index load(const std::uint64_t* data, size_type size) {
+        if (size < header_size || data[h_magic] != magic_ || data[h_version] != version_) {
+            throw std::invalid_argument("Not a serialized fm_index");
+        }
+        // Every row takes at least a bit in each level, bounding the sizes before computing
+        // the layout so it cannot overflow.
+        const auto text_size = data[h_text_size];
+        const auto num_samples = data[h_num_samples];
+        if (text_size / 64 >= size || data[h_sample_rate] == 0 || data[h_sentinel_row] > text_size || num_samples > text_size + 1
+            || layout(static_cast<size_type>(text_size) + 1, static_cast<size_type>(num_samples)).total != size) {
+            throw std::invalid_argument("Corrupt fm_index");
+        }
+        fm_index retval;
+        retval.attach(data, size);
+        if (!retval.has_consistent_totals()) {
+            throw std::invalid_argument("Corrupt fm_index");
+        }
+        return retval;
+    }
+
+    /**
+     * @brief Get the words of the index, to be stored and later passed to `load()`
+     */
+    [[nodiscard]] const std::uint64_t* data() const noexcept {
+        return data_;
+    }
+
+    /**
+     * @brief Get the number of words of the index
+     */
+    [[nodiscard]] size_type data_size() const noexcept {
+        return size_;
+    }
+
+    /**
+     * @brief Get the size of the indexed text
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return rows_ - 1;
+    }
+
+    [[nodiscard]] size_type sample_rate() const noexcept {
+        return static_cast<size_type>(data_[h_sample_rate]);
+    }
+
+    /**
+     * @brief Count the, possibly overlapping, occurrences of `needle`
+     *
+     * An empty needle matches at every position of the text.
+     */
+    [[nodiscard]] size_type count(string_view needle) const noexcept {
+        const auto range = row_range(needle);
+        return range.second - range.first;
+    }
+
+    [[nodiscard]] bool contains(string_view needle) const noexcept {
+        return count(needle) != 0;
+    }
+
+    /**
+     * @brief Find the positions of all, possibly overlapping, occurrences of `needle`
+     * @return The positions in ascending order.
+     */
+    [[nodiscard]] std::vector<size_type> locate(string_view needle) const {
+        const auto range = row_range(needle);
+        std::vector<size_type> retval;
+        retval.reserve(range.second - range.first);
+        const auto* sampled = data_ + layout_.sampled;
+        for (auto row = range.first; row < range.second; ++row) {
+            auto i = row;
+            size_type steps = 0;
+            while (!detail::rank_bits::get(sampled, i)) {
+                i = last_to_first(i);
+                ++steps;
+            }
+            retval.push_back(static_cast<size_type>(data_[layout_.samples + detail::rank_bits::rank1(sampled, i)]) + steps);
+        }
+        std::sort(retval.begin(), retval.end());
+        return retval;
+    }
+};
+}// namespace andwass
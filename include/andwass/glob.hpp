@@ -0,0 +1,535 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace andwass {
+namespace detail
+{
+/**
+ * @brief Find the end of the glob token starting at `pos`
+ * @return The index one past the token. A `[` without a closing `]` is a literal `[`.
+ */
+inline constexpr std::size_t glob_token_end(string_view pattern, std::size_t pos) noexcept {
+    if (pattern[pos] == '\\' && pos + 1 < pattern.size()) {
+        return pos + 2;
+    }
+    else if (pattern[pos] == '[') {
+        auto i = pos + 1;
+        if (i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^')) {
+            ++i;
+        }
+        // A ']' directly after the opening bracket is part of the set.
+        if (i < pattern.size() && pattern[i] == ']') {
+            ++i;
+        }
+        while (i < pattern.size() && pattern[i] != ']') {
+            ++i;
+        }
+        if (i < pattern.size()) {
+            return i + 1;
+        }
+    }
+    return pos + 1;
+}
+
+/**
+ * @brief Check if the (non-star) glob token `[pos, end)` matches `ch`
+ */
+inline constexpr bool glob_token_matches(string_view pattern, std::size_t pos, std::size_t end, char ch) noexcept {
+    if (end - pos == 1) {
+        return pattern[pos] == '?' || pattern[pos] == ch;
+    }
+    else if (pattern[pos] == '\\') {
+        return pattern[pos + 1] == ch;
+    }
+    auto i = pos + 1;
+    const auto last = end - 1;
+    const bool negate = pattern[i] == '!' || pattern[i] == '^';
+    if (negate) {
+        ++i;
+    }
+    bool found = false;
+    const auto uch = static_cast<unsigned char>(ch);
+    for (; i < last; ++i) {
+        if (i + 2 < last && pattern[i + 1] == '-') {
+            const auto lo = static_cast<unsigned char>(pattern[i]);
+            const auto hi = static_cast<unsigned char>(pattern[i + 2]);
+            found = found || (uch >= lo && uch <= hi);
+            i += 2;
+        }
+        else {
+            found = found || pattern[i] == ch;
+        }
+    }
+    return found != negate;
+}
+
+/**
+ * @brief Aho-Corasick automaton reporting which of a set of needles occur in a text.
+ *
+ * The alphabet is compressed to the bytes that occur in the needles, and the
+ * transition table is fully expanded so scanning is one table lookup per char.
+ */
+class aho_corasick {
+    static constexpr std::uint32_t no_node = ~std::uint32_t(0);
+
+    std::array<std::uint32_t, 256> byte_class_{};
+    std::uint32_t num_classes_ = 1;
+    std::vector<std::uint32_t> transitions_;
+    std::vector<std::uint32_t> needle_;
+    std::vector<std::uint32_t> fail_;
+    // Closest node on the failure chain, including the node itself, that ends a needle.
+    std::vector<std::uint32_t> output_;
+    std::size_t num_needles_ = 0;
+
+    std::uint32_t add_node() {
+        transitions_.resize(transitions_.size() + num_classes_, 0);
+        needle_.push_back(no_node);
+        return static_cast<std::uint32_t>(needle_.size() - 1);
+    }
+
+    [[nodiscard]] std::uint32_t& next(std::uint32_t node, std::uint32_t cls) noexcept {
+        return transitions_[node * num_classes_ + cls];
+    }
+
+public:
+    aho_corasick() = default;
+
+    /**
+     * @brief Build the automaton
+     * @param needles Non-empty needles, a needle equal to an earlier one is never reported.
+     */
+    explicit aho_corasick(const std::vector<string_view>& needles): num_needles_(needles.size()) {
+        for (auto needle: needles) {
+            for (auto ch: needle) {
+                auto& cls = byte_class_[static_cast<unsigned char>(ch)];
+                if (cls == 0) {
+                    cls = num_classes_++;
+                }
+            }
+        }
+        add_node();
+        for (std::size_t i = 0; i < needles.size(); i++) {
+            std::uint32_t node = 0;
+            for (auto ch: needles[i]) {
+                const auto cls = byte_class_[static_cast<unsigned char>(ch)];
+                if (next(node, cls) == 0) {
+                    const auto child = add_node();
+                    next(node, cls) = child;
+                }
+                node = next(node, cls);
+            }
+            if (node != 0 && needle_[node] == no_node) {
+                needle_[node] = static_cast<std::uint32_t>(i);
+            }
+        }
+
+        // Breadth first, turning the trie into a complete automaton.
+        fail_.assign(needle_.size(), 0);
+        output_.assign(needle_.size(), no_node);
+        std::vector<std::uint32_t> queue;
+        for (std::uint32_t cls = 0; cls < num_classes_; cls++) {
+            if (const auto child = next(0, cls); child != 0) {
+                queue.push_back(child);
+            }
+        }
+        for (std::size_t head = 0; head < queue.size(); head++) {
+            const auto node = queue[head];
+            output_[node] = needle_[node] != no_node ? node : output_[fail_[node]];
+            for (std::uint32_t cls = 0; cls < num_classes_; cls++) {
+                const auto child = next(node, cls);
+                if (child != 0) {
+                    fail_[child] = next(fail_[node], cls);
+                    queue.push_back(child);
+                }
+                else {
+                    next(node, cls) = next(fail_[node], cls);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return num_needles_;
+    }
+
+    /**
+     * @brief Report every needle that occurs in `text` once
+     * @param found Scratch space of `size()` zeroes, set to non-zero for each found needle.
+     * @param on_found Called with the index of every found needle.
+     */
+    template<class F>
+    void scan(string_view text, std::vector<char>& found, F&& on_found) const {
+        if (num_needles_ == 0) {
+            return;
+        }
+        std::uint32_t node = 0;
+        for (auto ch: text) {
+            node = transitions_[node * num_classes_ + byte_class_[static_cast<unsigned char>(ch)]];
+            // Once a needle is marked, the rest of its output chain has been marked too.
+            for (auto out = output_[node]; out != no_node && !found[needle_[out]]; out = output_[fail_[out]]) {
+                found[needle_[out]] = 1;
+                on_found(needle_[out]);
+            }
+        }
+    }
+};
+}
+
+/**
+ * @brief Match a text against a glob pattern
+ * @param pattern The pattern
+ * @param text The text to match
+ * @return True if the whole `text` matches `pattern`.
+ *
+ * Supported syntax:
+ *   * `*` matches any sequence of chars, including none.
+ *   * `?` matches any single char.
+ *   * `[abc]`, `[a-z]` match one char in the set, `[!a-z]` or `[^a-z]` one char not in the set.
+ *     A `]` directly after the opening bracket is part of the set.
+ *   * `\x` matches `x` literally.
+ *
+ * Only the most recent `*` is ever retried, so matching never backtracks exponentially.
+ * The worst case is `O(pattern.size() * text.size())`, typical patterns are linear.
+ */
+[[nodiscard]] constexpr bool glob_match(string_view pattern, string_view text) noexcept {
+    std::size_t p = 0;
+    std::size_t t = 0;
+    std::size_t star_p = string_view::npos;
+    std::size_t star_t = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            star_p = ++p;
+            star_t = t;
+            continue;
+        }
+        if (p < pattern.size()) {
+            const auto end = detail::glob_token_end(pattern, p);
+            if (detail::glob_token_matches(pattern, p, end, text[t])) {
+                p = end;
+                ++t;
+                continue;
+            }
+        }
+        if (star_p == string_view::npos) {
+            return false;
+        }
+        // Let the last star swallow one more char and retry from there.
+        p = star_p;
+        t = ++star_t;
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+/**
+ * @brief A precompiled glob pattern
+ *
+ * The pattern is split on `*` into segments of single-char tokens. The first segment is
+ * anchored to the start of the text, the last one to the end, and the segments in between
+ * are searched for leftmost-first. Each segment keeps its longest literal run which is
+ * searched for with `string_view::find`, so most of the text is skipped without
+ * inspecting tokens one by one.
+ *
+ * See `glob_match` for the supported syntax.
+ */
+class glob {
+    struct segment {
+        std::size_t first_token = 0;
+        std::size_t size = 0;
+        std::string literal;
+        std::size_t literal_offset = 0;
+    };
+
+    std::string pattern_;
+    std::vector<std::bitset<256>> tokens_;
+    std::vector<segment> segments_;
+    bool leading_star_ = false;
+    bool trailing_star_ = false;
+
+    [[nodiscard]] bool segment_matches_at(const segment& seg, string_view text, std::size_t pos) const noexcept {
+        if (seg.literal.size() == seg.size) {
+            return text.substr(pos, seg.size) == string_view(seg.literal.data(), seg.literal.size());
+        }
+        for (std::size_t i = 0; i < seg.size; i++) {
+            if (!tokens_[seg.first_token + i].test(static_cast<unsigned char>(text[pos + i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] std::size_t find_segment(const segment& seg, string_view text, std::size_t from) const noexcept {
+        if (seg.size > text.size() || from > text.size() - seg.size) {
+            return string_view::npos;
+        }
+        const auto last_start = text.size() - seg.size;
+        if (seg.literal.empty()) {
+            for (auto pos = from; pos <= last_start; pos++) {
+                if (segment_matches_at(seg, text, pos)) {
+                    return pos;
+                }
+            }
+            return string_view::npos;
+        }
+        const string_view literal(seg.literal.data(), seg.literal.size());
+        auto search_from = from + seg.literal_offset;
+        while (true) {
+            const auto found = text.substr(search_from).find(literal);
+            if (found == string_view::npos) {
+                return string_view::npos;
+            }
+            const auto start = search_from + found - seg.literal_offset;
+            if (start > last_start) {
+                return string_view::npos;
+            }
+            if (segment_matches_at(seg, text, start)) {
+                return start;
+            }
+            search_from += found + 1;
+        }
+    }
+
+public:
+    /**
+     * @brief Compile a glob pattern
+     * @param pattern The pattern, see `glob_match` for the syntax.
+     */
+    explicit glob(string_view pattern): pattern_(pattern.data(), pattern.size()) {
+        segment current;
+        std::size_t run_start = 0;
+        std::string run;
+        auto end_run = [&]() {
+            if (run.size() > current.literal.size()) {
+                current.literal = run;
+                current.literal_offset = run_start;
+            }
+            run.clear();
+        };
+        std::size_t pos = 0;
+        while (pos < pattern.size()) {
+            if (pattern[pos] == '*') {
+                leading_star_ = leading_star_ || pos == 0;
+                trailing_star_ = true;
+                end_run();
+                if (current.size > 0) {
+                    segments_.push_back(std::move(current));
+                    current = segment();
+                }
+                current.first_token = tokens_.size();
+                ++pos;
+                continue;
+            }
+            trailing_star_ = false;
+            const auto end = detail::glob_token_end(pattern, pos);
+            std::bitset<256> accepts;
+            for (int ch = 0; ch < 256; ch++) {
+                accepts[static_cast<std::size_t>(ch)] = detail::glob_token_matches(pattern, pos, end, static_cast<char>(ch));
+            }
+            if (accepts.count() == 1) {
+                if (run.empty()) {
+                    run_start = current.size;
+                }
+                std::size_t ch = 0;
+                while (!accepts[ch]) {
+                    ++ch;
+                }
+                run += static_cast<char>(ch);
+            }
+            else {
+                end_run();
+            }
+            tokens_.push_back(accepts);
+            ++current.size;
+            pos = end;
+        }
+        end_run();
+        if (current.size > 0) {
+            segments_.push_back(std::move(current));
+        }
+    }
+
+    /**
+     * @brief Get the source pattern
+     */
+    [[nodiscard]] string_view pattern() const noexcept {
+        return string_view(pattern_.data(), pattern_.size());
+    }
+
+    /**
+     * @brief Get the longest run of literal chars in the pattern
+     * @return A view of a literal that every matching text contains, possibly empty.
+     */
+    [[nodiscard]] string_view longest_literal() const noexcept {
+        string_view retval;
+        for (const auto& seg: segments_) {
+            if (seg.literal.size() > retval.size()) {
+                retval = string_view(seg.literal.data(), seg.literal.size());
+            }
+        }
+        return retval;
+    }
+
+    /**
+     * @brief Check if a text matches the pattern
+     * @param text The text to match
+     * @return True if the whole `text` matches, equivalent to `glob_match(pattern(), text)`.
+     */
+    [[nodiscard]] bool matches(string_view text) const noexcept {
+        if (segments_.empty()) {
+            return leading_star_ || text.is_empty();
+        }
+        if (!leading_star_ && segments_.size() == 1 && !trailing_star_) {
+            return text.size() == segments_.front().size && segment_matches_at(segments_.front(), text, 0);
+        }
+
+        std::size_t first = 0;
+        std::size_t last = segments_.size();
+        std::size_t begin = 0;
+        std::size_t end = text.size();
+        if (!leading_star_) {
+            const auto& seg = segments_.front();
+            if (seg.size > text.size() || !segment_matches_at(seg, text, 0)) {
+                return false;
+            }
+            begin = seg.size;
+            ++first;
+        }
+        if (!trailing_star_) {
+            const auto& seg = segments_.back();
+            if (seg.size > end - begin || !segment_matches_at(seg, text, end - seg.size)) {
+                return false;
+            }
+            end -= seg.size;
+            --last;
+        }
+        const auto middle = text.substr(0, end);
+        for (auto i = first; i < last; ++i) {
+            const auto found = find_segment(segments_[i], middle, begin);
+            if (found == string_view::npos) {
+                return false;
+            }
+            begin = found + segments_[i].size;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief A set of glob patterns matched against a text at once
+ *
+ * Every pattern that contains a literal char is only evaluated when its longest literal
+ * occurs in the text. The distinct literals of all patterns are searched for in a single
+ * pass with an Aho-Corasick automaton, so the cost of a text is mostly independent of the
+ * number of patterns that cannot match it.
+ */
+class glob_set {
+    std::vector<glob> globs_;
+    std::vector<std::size_t> unfiltered_;
+    std::vector<std::vector<std::size_t>> by_literal_;
+    detail::aho_corasick literals_;
+
+    void build() {
+        std::vector<string_view> literals;
+        for (std::size_t id = 0; id < globs_.size(); id++) {
+            const auto literal = globs_[id].longest_literal();
+            if (literal.is_empty()) {
+                unfiltered_.push_back(id);
+                continue;
+            }
+            const auto existing = std::find(literals.begin(), literals.end(), literal);
+            if (existing == literals.end()) {
+                literals.push_back(literal);
+                by_literal_.emplace_back(1, id);
+            }
+            else {
+                by_literal_[static_cast<std::size_t>(existing - literals.begin())].push_back(id);
+            }
+        }
+        literals_ = detail::aho_corasick(literals);
+    }
+
+public:
+    /**
+     * @brief Create an empty set
+     */
+    glob_set() = default;
+
+    /**
+     * @brief Compile a set of patterns
+     * @param first, last A range of patterns convertible to `string_view`. The id of a pattern is its index in the range.
+     */
+    template<class Iter>
+    glob_set(Iter first, Iter last) {
+        for (; first != last; ++first) {
+            globs_.emplace_back(string_view(*first));
+        }
+        build();
+    }
+
+    glob_set(std::initializer_list<string_view> patterns): glob_set(patterns.begin(), patterns.end()) {}
+
+    /**
+     * @brief Get the number of patterns in the set
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        return globs_.size();
+    }
+
+    /**
+     * @brief Get a pattern by id
+     */
+    [[nodiscard]] const glob& operator[](std::size_t id) const noexcept {
+        return globs_[id];
+    }
+
+    /**
+     * @brief Find all patterns that match a text
+     * @param text The text to match
+     * @param ids The ids of all matching patterns are appended in ascending order.
+     */
+    void matches(string_view text, std::vector<std::size_t>& ids) const {
+        const auto first_new = ids.size();
+        for (auto id: unfiltered_) {
+            if (globs_[id].matches(text)) {
+                ids.push_back(id);
+            }
+        }
+        std::vector<char> found(literals_.size(), 0);
+        literals_.scan(text, found, [&](std::size_t literal) {
+            for (auto id: by_literal_[literal]) {
+                if (globs_[id].matches(text)) {
+                    ids.push_back(id);
+                }
+            }
+        });
+        std::sort(ids.begin() + static_cast<std::ptrdiff_t>(first_new), ids.end());
+    }
+
+    /**
+     * @brief Find all patterns that match a text
+     * @param text The text to match
+     * @return The ids of all matching patterns in ascending order.
+     */
+    [[nodiscard]] std::vector<std::size_t> matches(string_view text) const {
+        std::vector<std::size_t> ids;
+        matches(text, ids);
+        return ids;
+    }
+};
+}// namespace andwass
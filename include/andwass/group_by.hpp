@@ -0,0 +1,237 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/flat_string_map.hpp>
+#include <andwass/string_view.hpp>
+#include <andwass/detail/parallel.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace andwass {
+/**
+ * @brief A map from strings to `V` split into disjoint `flat_string_map` partitions
+ *
+ * The partition of a key is selected by the top bits of its hash, so every key is in
+ * exactly one partition and partitions can be built and read independently.
+ */
+template<class V>
+class partitioned_string_map {
+public:
+    using size_type = std::size_t;
+    using mapped_type = V;
+
+private:
+    std::vector<flat_string_map<V>> partitions_;
+    unsigned partition_bits_ = 0;
+
+public:
+    /**
+     * @brief Construct `2^partition_bits` empty partitions
+     */
+    explicit partitioned_string_map(unsigned partition_bits = 0): partitions_(std::size_t(1) << partition_bits), partition_bits_(partition_bits) {}
+
+    /**
+     * @brief Get the index of the partition that holds `key`
+     */
+    [[nodiscard]] size_type partition_of(string_view key) const noexcept {
+        return partition_of_hash(andwass::hash(key));
+    }
+
+    /**
+     * @brief Get the index of the partition that holds a key with hash `hash`
+     */
+    [[nodiscard]] size_type partition_of_hash(std::uint64_t hash) const noexcept {
+        return partition_bits_ == 0 ? 0 : static_cast<size_type>(hash >> (64 - partition_bits_));
+    }
+
+    [[nodiscard]] size_type partition_count() const noexcept {
+        return partitions_.size();
+    }
+
+    [[nodiscard]] flat_string_map<V>& partition(size_type i) noexcept {
+        return partitions_[i];
+    }
+
+    [[nodiscard]] const flat_string_map<V>& partition(size_type i) const noexcept {
+        return partitions_[i];
+    }
+
+    /**
+     * @brief Get the number of keys in all partitions
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        size_type retval = 0;
+        for (const auto& p: partitions_) {
+            retval += p.size();
+        }
+        return retval;
+    }
+
+    [[nodiscard]] bool is_empty() const noexcept {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Find the value of a key
+     * @return A pointer to the value, or `nullptr` if `key` is not in the map.
+     */
+    [[nodiscard]] V* find(string_view key) noexcept {
+        return partitions_[partition_of(key)].find(key);
+    }
+
+    [[nodiscard]] const V* find(string_view key) const noexcept {
+        return partitions_[partition_of(key)].find(key);
+    }
+
+    [[nodiscard]] bool contains(string_view key) const noexcept {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * @brief Call `f(key, value)` for every key, one partition after the other
+     */
+    template<class F>
+    void for_each(F&& f) const {
+        for (const auto& p: partitions_) {
+            p.for_each(f);
+        }
+    }
+
+    template<class F>
+    void for_each(F&& f) {
+        for (auto& p: partitions_) {
+            p.for_each(f);
+        }
+    }
+};
+
+namespace detail
+{
+/**
+ * @brief Aggregate records `[0, count)` by key
+ * @param key `key(i)` returns the `string_view` key of record `i`.
+ * @param add `add(value, i)` folds record `i` into the value of its key.
+ *
+ * Every thread first scatters the indices of a contiguous chunk of records, along with their
+ * key hashes so no key is hashed twice, into partitions selected by the top bits of the
+ * hash. Every thread then owns a disjoint set of partitions and aggregates them into the
+ * tables of the result, so no locks are taken, equal keys never meet in different tables,
+ * and no table is merged afterwards.
+ */
+template<class V, class Key, class Add>
+partitioned_string_map<V> aggregate_by_key(std::size_t count, unsigned num_threads, Key key, Add add) {
+    constexpr std::size_t min_records_per_thread = 4096;
+
+    if (num_threads == 0) {
+        num_threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+    num_threads = static_cast<unsigned>((std::min)(std::size_t(num_threads), (std::max)(count / min_records_per_thread, std::size_t(1))));
+
+    if (num_threads == 1) {
+        partitioned_string_map<V> retval;
+        auto& table = retval.partition(0);
+        for (std::size_t i = 0; i < count; ++i) {
+            add(table[key(i)], i);
+        }
+        return retval;
+    }
+
+    // At least 4 partitions per thread to even out skewed key distributions.
+    unsigned partition_bits = 2;
+    while ((1u << partition_bits) < num_threads * 4) {
+        ++partition_bits;
+    }
+    partitioned_string_map<V> retval(partition_bits);
+    const auto num_partitions = retval.partition_count();
+
+    struct record {
+        std::size_t index;
+        std::uint64_t hash;
+    };
+    // scattered[t][p] holds the records of partition `p` from the chunk of thread `t`.
+    std::vector<std::vector<std::vector<record>>> scattered(num_threads, std::vector<std::vector<record>>(num_partitions));
+    const auto chunk = (count + num_threads - 1) / num_threads;
+
+    run_parallel(num_threads, [&](unsigned t) {
+        const auto first = (std::min)(count, t * chunk);
+        const auto last = (std::min)(count, first + chunk);
+        auto& parts = scattered[t];
+        for (auto& part: parts) {
+            part.reserve((last - first) / num_partitions + 16);
+        }
+        for (auto i = first; i < last; ++i) {
+            const auto hash = andwass::hash(key(i));
+            parts[retval.partition_of_hash(hash)].push_back(record{i, hash});
+        }
+    });
+
+    run_parallel(num_threads, [&](unsigned t) {
+        for (auto p = std::size_t(t); p < num_partitions; p += num_threads) {
+            auto& table = retval.partition(p);
+            for (const auto& parts: scattered) {
+                for (const auto& r: parts[p]) {
+                    add(*table.try_emplace_hashed(key(r.index), r.hash).first, r.index);
+                }
+            }
+        }
+    });
+    return retval;
+}
+}// namespace detail
+
+/**
+ * @brief Count the occurrences of every distinct key, using several threads
+ * @param first, last A random access range of keys convertible to `string_view`
+ * @param num_threads The number of threads to use, 0 to use one per hardware thread.
+ * @return A map from every distinct key to its number of occurrences.
+ *
+ * The partitions of the result are the tables the threads aggregated into, they are
+ * returned as is. Small inputs are counted on the calling thread only, into one partition.
+ */
+template<class Iter>
+partitioned_string_map<std::uint64_t> count_by_key(Iter first, Iter last, unsigned num_threads = 0) {
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+    return detail::aggregate_by_key<std::uint64_t>(
+        count, num_threads,
+        [first](std::size_t i) {
+            return string_view(first[static_cast<typename std::iterator_traits<Iter>::difference_type>(i)]);
+        },
+        [](std::uint64_t& value, std::size_t) {
+            ++value;
+        });
+}
+
+/**
+ * @brief Sum values per distinct key, using several threads
+ * @param first, last A random access range of keys convertible to `string_view`
+ * @param values A random access iterator to the value of every key, in the same order.
+ * @param num_threads The number of threads to use, 0 to use one per hardware thread.
+ * @return A map from every distinct key to the sum of its values.
+ *
+ * The partitions of the result are the tables the threads aggregated into, they are
+ * returned as is. Small inputs are summed on the calling thread only, into one partition.
+ */
+template<class Iter, class ValueIter>
+partitioned_string_map<typename std::iterator_traits<ValueIter>::value_type> sum_by_key(Iter first, Iter last, ValueIter values, unsigned num_threads = 0) {
+    using value_type = typename std::iterator_traits<ValueIter>::value_type;
+    using difference_type = typename std::iterator_traits<Iter>::difference_type;
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+    return detail::aggregate_by_key<value_type>(
+        count, num_threads,
+        [first](std::size_t i) {
+            return string_view(first[static_cast<difference_type>(i)]);
+        },
+        [values](value_type& sum, std::size_t i) {
+            sum += values[static_cast<typename std::iterator_traits<ValueIter>::difference_type>(i)];
+        });
+}
+}// namespace andwass
@@ -0,0 +1,485 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+#include <andwass/detail/bits.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace andwass {
+namespace detail
+{
+/**
+ * @brief Fixed-size key slots carved from shared blocks, released slots are reused
+ *
+ * Slot sizes are powers of two from 16 bytes, and a released slot is put on the free list
+ * of its size, threaded through the slot itself. Slots never move, so views of them stay
+ * valid until the slot is released or the slab is cleared.
+ */
+class key_slab {
+    static constexpr std::size_t block_size = 16 * 1024;
+    static constexpr std::size_t min_slot = 16;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    std::array<char*, 48> free_{};
+    char* current_ = nullptr;
+    std::size_t remaining_ = 0;
+
+public:
+    [[nodiscard]] static unsigned size_class(std::size_t size) noexcept {
+        return size <= min_slot ? 0 : static_cast<unsigned>(64 - countl_zero(size - 1) - 4);
+    }
+
+    [[nodiscard]] static std::size_t slot_size(unsigned cls) noexcept {
+        return min_slot << cls;
+    }
+
+    key_slab() = default;
+
+    key_slab(key_slab&& rhs) noexcept
+        : blocks_(std::move(rhs.blocks_)), free_(std::exchange(rhs.free_, {})), current_(std::exchange(rhs.current_, nullptr)),
+          remaining_(std::exchange(rhs.remaining_, 0)) {}
+
+    key_slab& operator=(key_slab&& rhs) noexcept {
+        if (this != &rhs) {
+            blocks_ = std::move(rhs.blocks_);
+            free_ = std::exchange(rhs.free_, {});
+            current_ = std::exchange(rhs.current_, nullptr);
+            remaining_ = std::exchange(rhs.remaining_, 0);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Get a slot of `slot_size(cls)` bytes
+     */
+    [[nodiscard]] char* allocate(unsigned cls) {
+        if (char* slot = free_[cls]) {
+            std::memcpy(&free_[cls], slot, sizeof(char*));
+            return slot;
+        }
+        const auto size = slot_size(cls);
+        if (size > block_size) {
+            std::unique_ptr<char[]> block(new char[size]);
+            blocks_.push_back(std::move(block));
+            return blocks_.back().get();
+        }
+        if (size > remaining_) {
+            std::unique_ptr<char[]> block(new char[block_size]);
+            blocks_.push_back(std::move(block));
+            current_ = blocks_.back().get();
+            remaining_ = block_size;
+        }
+        char* slot = current_;
+        current_ += size;
+        remaining_ -= size;
+        return slot;
+    }
+
+    void release(char* slot, unsigned cls) noexcept {
+        std::memcpy(slot, &free_[cls], sizeof(char*));
+        free_[cls] = slot;
+    }
+
+    void clear() noexcept {
+        blocks_.clear();
+        free_ = {};
+        current_ = nullptr;
+        remaining_ = 0;
+    }
+};
+}// namespace detail
+
+/**
+ * @brief Track the most frequent strings of a stream with the Space-Saving algorithm
+ *
+ * At most `capacity()` strings are monitored. An unmonitored string replaces one with the
+ * smallest count and inherits that count as its possible overestimation (`error`). Any
+ * string occurring more than `total() / capacity()` times is guaranteed to be monitored.
+ *
+ * Counters are kept in a stream summary: a list of buckets sorted by count, each holding
+ * the counters with that count, so counting an occurrence is O(1). A string is only copied
+ * when it starts being monitored, into a slot of a block shared by all keys. The slot does
+ * not move when counters are added or the tracker is moved, and an evicted string's slot
+ * is overwritten by its replacement when it fits.
+ */
+class heavy_hitters {
+public:
+    using size_type = std::size_t;
+    using count_type = std::uint64_t;
+
+    /**
+     * @brief A monitored string
+     *
+     * The true number of occurrences is in `[count - error, count]`.
+     */
+    struct entry {
+        string_view key;
+        count_type count;
+        count_type error;
+    };
+
+private:
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    struct counter {
+        char* key = nullptr;
+        size_type key_size = 0;
+        unsigned key_class = 0;
+        count_type error = 0;
+        size_type bucket = npos;
+        size_type prev = npos;
+        size_type next = npos;
+    };
+
+    struct bucket {
+        count_type count = 0;
+        size_type first = npos;
+        size_type prev = npos;
+        size_type next = npos;
+    };
+
+    size_type capacity_;
+    count_type total_ = 0;
+    std::vector<counter> counters_;
+    detail::key_slab keys_;
+    // Views of the counter keys, which do not move when `counters_` reallocates.
+    std::unordered_map<string_view, size_type> index_;
+    std::vector<bucket> buckets_;
+    std::vector<size_type> free_buckets_;
+    // Bucket with the smallest and largest count.
+    size_type head_ = npos;
+    size_type tail_ = npos;
+
+    [[nodiscard]] static string_view view_of(const counter& ctr) noexcept {
+        return string_view(ctr.key, ctr.key_size);
+    }
+
+    /**
+     * @brief Reserve room for `capacity_` counters so updating the summary cannot throw
+     *
+     * There are never more buckets than counters, so once reserved only copying a new key
+     * and adding it to the index can allocate.
+     */
+    void reserve_summary() {
+        counters_.reserve(capacity_);
+        index_.reserve(capacity_);
+        buckets_.reserve(capacity_);
+        free_buckets_.reserve(capacity_);
+    }
+
+    /**
+     * @brief Add an unattached counter for `key`
+     */
+    size_type push_counter(string_view key, count_type error) {
+        const auto cls = detail::key_slab::size_class(key.size());
+        char* data = keys_.allocate(cls);
+        std::copy_n(key.data(), key.size(), data);
+        const auto c = counters_.size();
+        try {
+            index_.emplace(string_view(data, key.size()), c);
+        }
+        catch (...) {
+            keys_.release(data, cls);
+            throw;
+        }
+        counters_.push_back(counter{data, key.size(), cls, error});
+        return c;
+    }
+
+    size_type new_bucket(count_type count, size_type prev, size_type next) {
+        size_type b;
+        if (free_buckets_.empty()) {
+            b = buckets_.size();
+            buckets_.emplace_back();
+        }
+        else {
+            b = free_buckets_.back();
+            free_buckets_.pop_back();
+        }
+        buckets_[b] = bucket{count, npos, prev, next};
+        (prev == npos ? head_ : buckets_[prev].next) = b;
+        (next == npos ? tail_ : buckets_[next].prev) = b;
+        return b;
+    }
+
+    void detach(size_type c) noexcept {
+        auto& ctr = counters_[c];
+        auto& bkt = buckets_[ctr.bucket];
+        (ctr.prev == npos ? bkt.first : counters_[ctr.prev].next) = ctr.next;
+        if (ctr.next != npos) {
+            counters_[ctr.next].prev = ctr.prev;
+        }
+        if (bkt.first == npos) {
+            (bkt.prev == npos ? head_ : buckets_[bkt.prev].next) = bkt.next;
+            (bkt.next == npos ? tail_ : buckets_[bkt.next].prev) = bkt.prev;
+            free_buckets_.push_back(ctr.bucket);
+        }
+        ctr.bucket = npos;
+    }
+
+    void attach(size_type c, size_type b) noexcept {
+        auto& ctr = counters_[c];
+        auto& bkt = buckets_[b];
+        ctr.bucket = b;
+        ctr.prev = npos;
+        ctr.next = bkt.first;
+        if (bkt.first != npos) {
+            counters_[bkt.first].prev = c;
+        }
+        bkt.first = c;
+    }
+
+    /**
+     * @brief Move counter `c` to the bucket for `count`, searching forward from bucket `after`
+     * @param after The bucket to start from, or `npos` to start at the smallest count.
+     */
+    void place(size_type c, count_type count, size_type after) {
+        auto prev = after;
+        auto next = after == npos ? head_ : buckets_[after].next;
+        while (next != npos && buckets_[next].count < count) {
+            prev = next;
+            next = buckets_[next].next;
+        }
+        if (next != npos && buckets_[next].count == count) {
+            attach(c, next);
+        }
+        else {
+            attach(c, new_bucket(count, prev, next));
+        }
+    }
+
+    void add(size_type c, count_type count) {
+        const auto b = counters_[c].bucket;
+        const auto new_count = buckets_[b].count + count;
+        if (buckets_[b].first == c && counters_[c].next == npos) {
+            const auto next = buckets_[b].next;
+            if (next == npos || buckets_[next].count > new_count) {
+                // Sole counter of its bucket that stays in order, update in place.
+                buckets_[b].count = new_count;
+                return;
+            }
+        }
+        // Start from the bucket before `b`, which stays valid even if `b` is released.
+        const auto prev = buckets_[b].prev;
+        detach(c);
+        place(c, new_count, prev);
+    }
+
+    void clear_summary() noexcept {
+        counters_.clear();
+        keys_.clear();
+        index_.clear();
+        buckets_.clear();
+        free_buckets_.clear();
+        head_ = npos;
+        tail_ = npos;
+        total_ = 0;
+    }
+
+    [[nodiscard]] count_type min_count() const noexcept {
+        return counters_.size() < capacity_ || head_ == npos ? 0 : buckets_[head_].count;
+    }
+
+public:
+    /**
+     * @brief Construct an empty tracker
+     * @param capacity The maximum number of strings to monitor.
+     *
+     * @note Throws `std::invalid_argument` if `capacity` is 0.
+     */
+    explicit heavy_hitters(size_type capacity): capacity_(capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("heavy_hitters capacity must not be 0");
+        }
+        reserve_summary();
+    }
+
+    heavy_hitters(const heavy_hitters&) = delete;
+    heavy_hitters& operator=(const heavy_hitters&) = delete;
+
+    /**
+     * @brief Move construct, `rhs` is left empty with the same capacity
+     */
+    heavy_hitters(heavy_hitters&& rhs) noexcept
+        : capacity_(rhs.capacity_), total_(std::exchange(rhs.total_, 0)), counters_(std::move(rhs.counters_)),
+          keys_(std::move(rhs.keys_)), index_(std::move(rhs.index_)), buckets_(std::move(rhs.buckets_)), free_buckets_(std::move(rhs.free_buckets_)),
+          head_(std::exchange(rhs.head_, npos)), tail_(std::exchange(rhs.tail_, npos)) {
+        rhs.clear_summary();
+    }
+
+    heavy_hitters& operator=(heavy_hitters&& rhs) noexcept {
+        if (this != &rhs) {
+            capacity_ = rhs.capacity_;
+            total_ = std::exchange(rhs.total_, 0);
+            counters_ = std::move(rhs.counters_);
+            keys_ = std::move(rhs.keys_);
+            index_ = std::move(rhs.index_);
+            buckets_ = std::move(rhs.buckets_);
+            free_buckets_ = std::move(rhs.free_buckets_);
+            head_ = std::exchange(rhs.head_, npos);
+            tail_ = std::exchange(rhs.tail_, npos);
+            rhs.clear_summary();
+        }
+        return *this;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept {
+        return capacity_;
+    }
+
+    /**
+     * @brief Get the number of monitored strings
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return counters_.size();
+    }
+
+    /**
+     * @brief Get the sum of all counts inserted
+     */
+    [[nodiscard]] count_type total() const noexcept {
+        return total_;
+    }
+
+    void clear() noexcept {
+        clear_summary();
+    }
+
+    /**
+     * @brief Count `count` occurrences of `key`
+     *
+     * O(1) when `count` is 1, otherwise linear in the number of distinct counts passed.
+     * If copying a new key throws the tracker is left unchanged.
+     */
+    void insert(string_view key, count_type count = 1) {
+        if (count == 0) {
+            return;
+        }
+        if (buckets_.capacity() < capacity_) {
+            // Moved from, restore the reservations the updates below rely on.
+            reserve_summary();
+        }
+        if (auto it = index_.find(key); it != index_.end()) {
+            add(it->second, count);
+        }
+        else if (counters_.size() < capacity_) {
+            place(push_counter(key, 0), count, npos);
+        }
+        else {
+            // Replace a counter with the smallest count, reusing its key slot if the key fits.
+            const auto c = buckets_[head_].first;
+            auto& ctr = counters_[c];
+            const auto cls = detail::key_slab::size_class(key.size());
+            char* data = ctr.key;
+            if (key.size() > detail::key_slab::slot_size(ctr.key_class)) {
+                data = keys_.allocate(cls);
+            }
+            // Reuse the index node, the index is reserved for `capacity_` keys so this cannot throw.
+            auto node = index_.extract(view_of(ctr));
+            if (data != ctr.key) {
+                keys_.release(ctr.key, ctr.key_class);
+                ctr.key_class = cls;
+            }
+            std::copy_n(key.data(), key.size(), data);
+            ctr.key = data;
+            ctr.key_size = key.size();
+            ctr.error = buckets_[head_].count;
+            node.key() = view_of(ctr);
+            index_.insert(std::move(node));
+            add(c, count);
+        }
+        total_ += count;
+    }
+
+    /**
+     * @brief Get the count of a monitored string
+     * @return The entry of `key`, or an entry with 0 count if it is not monitored.
+     */
+    [[nodiscard]] entry find(string_view key) const noexcept {
+        if (auto it = index_.find(key); it != index_.end()) {
+            const auto& ctr = counters_[it->second];
+            return entry{view_of(ctr), buckets_[ctr.bucket].count, ctr.error};
+        }
+        return entry{key, 0, 0};
+    }
+
+    /**
+     * @brief Get the `n` monitored strings with the highest counts, highest first
+     *
+     * The views in the returned entries are invalidated by the next modification.
+     */
+    [[nodiscard]] std::vector<entry> top(size_type n) const {
+        std::vector<entry> retval;
+        retval.reserve((std::min)(n, counters_.size()));
+        for (auto b = tail_; b != npos && retval.size() < n; b = buckets_[b].prev) {
+            for (auto c = buckets_[b].first; c != npos && retval.size() < n; c = counters_[c].next) {
+                retval.push_back(entry{view_of(counters_[c]), buckets_[b].count, counters_[c].error});
+            }
+        }
+        return retval;
+    }
+
+    /**
+     * @brief Merge the counts of `other` into this tracker, e.g. one filled by another thread
+     *
+     * A string not monitored by one of the trackers is assumed to have occurred as often as
+     * that tracker's smallest count, if it is full. The combined counts are summed and the
+     * `capacity()` largest are kept, which preserves the Space-Saving guarantees.
+     */
+    void merge(const heavy_hitters& other) {
+        const auto this_min = min_count();
+        const auto other_min = other.min_count();
+        // Keys are views into both trackers, which stay untouched until the result is built.
+        std::vector<entry> all;
+        all.reserve(counters_.size() + other.counters_.size());
+        for (const auto& ctr: counters_) {
+            const auto count = buckets_[ctr.bucket].count;
+            const auto in_other = other.find(view_of(ctr));
+            if (in_other.count != 0) {
+                all.push_back(entry{view_of(ctr), count + in_other.count, ctr.error + in_other.error});
+            }
+            else {
+                all.push_back(entry{view_of(ctr), count + other_min, ctr.error + other_min});
+            }
+        }
+        for (const auto& ctr: other.counters_) {
+            if (index_.find(view_of(ctr)) == index_.end()) {
+                const auto count = other.buckets_[ctr.bucket].count;
+                all.push_back(entry{view_of(ctr), count + this_min, ctr.error + this_min});
+            }
+        }
+
+        std::sort(all.begin(), all.end(), [](const entry& lhs, const entry& rhs) {
+            return lhs.count > rhs.count;
+        });
+        all.resize((std::min)(all.size(), capacity_));
+
+        heavy_hitters result(capacity_);
+        result.total_ = total_ + other.total_;
+        // Insert in ascending order so every counter lands in the last bucket.
+        for (auto it = all.rbegin(); it != all.rend(); ++it) {
+            const auto c = result.push_counter(it->key, it->error);
+            if (result.tail_ != npos && result.buckets_[result.tail_].count == it->count) {
+                result.attach(c, result.tail_);
+            }
+            else {
+                result.attach(c, result.new_bucket(it->count, result.tail_, npos));
+            }
+        }
+        *this = std::move(result);
+    }
+};
+}// namespace andwass
@@ -0,0 +1,186 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+#include <andwass/detail/bits.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace andwass {
+/**
+ * @brief Estimate the number of distinct strings in a stream in fixed memory
+ *
+ * The top `precision()` bits of the library `hash` select one of `2^precision()` registers,
+ * which keeps the highest rank (leading zeros + 1) seen among the remaining bits. The
+ * relative standard error of `estimate()` is about `1.04 / sqrt(2^precision())`.
+ *
+ * A new sketch starts out sparse, storing only the registers that have been set as a
+ * sorted list, and turns dense (one byte per register) once that would use less memory.
+ * Sketches with the same precision can be merged, e.g. after counting on several threads.
+ */
+class hyperloglog {
+public:
+    using size_type = std::size_t;
+
+    static constexpr unsigned min_precision = 4;
+    static constexpr unsigned max_precision = 18;
+
+private:
+    unsigned precision_;
+    // Dense registers, empty while the sketch is sparse.
+    std::vector<std::uint8_t> registers_;
+    // Sparse registers encoded as `index << 8 | rank`, sorted by index.
+    std::vector<std::uint32_t> sparse_;
+
+    [[nodiscard]] size_type num_registers() const noexcept {
+        return size_type(1) << precision_;
+    }
+
+    void set_sparse(std::uint32_t index, std::uint8_t rank) {
+        const auto entry = index << 8 | rank;
+        auto it = std::lower_bound(sparse_.begin(), sparse_.end(), index << 8);
+        if (it != sparse_.end() && (*it >> 8) == index) {
+            *it = (std::max)(*it, entry);
+            return;
+        }
+        sparse_.insert(it, entry);
+        if (sparse_.size() * sizeof(std::uint32_t) > num_registers()) {
+            to_dense();
+        }
+    }
+
+    void to_dense() {
+        registers_.assign(num_registers(), 0);
+        for (auto entry: sparse_) {
+            registers_[entry >> 8] = static_cast<std::uint8_t>(entry & 0xFF);
+        }
+        sparse_.clear();
+        sparse_.shrink_to_fit();
+    }
+
+    void set_register(std::uint32_t index, std::uint8_t rank) {
+        if (is_sparse()) {
+            set_sparse(index, rank);
+        }
+        else if (registers_[index] < rank) {
+            registers_[index] = rank;
+        }
+    }
+
+public:
+    /**
+     * @brief Construct an empty sketch
+     * @param precision Number of hash bits used to select a register, between 4 and 18.
+     *
+     * @note Throws `std::invalid_argument` if `precision` is out of range.
+     */
+    explicit hyperloglog(unsigned precision = 14): precision_(precision) {
+        if (precision < min_precision || precision > max_precision) {
+            throw std::invalid_argument("HyperLogLog precision must be between 4 and 18");
+        }
+    }
+
+    [[nodiscard]] unsigned precision() const noexcept {
+        return precision_;
+    }
+
+    [[nodiscard]] bool is_sparse() const noexcept {
+        return registers_.empty();
+    }
+
+    /**
+     * @brief Remove all strings, returning to the sparse representation
+     */
+    void clear() noexcept {
+        // Swapping with an empty vector frees the registers, unlike `shrink_to_fit` it never allocates.
+        std::vector<std::uint8_t>().swap(registers_);
+        sparse_.clear();
+    }
+
+    void insert(string_view str) {
+        insert_hash(andwass::hash(str));
+    }
+
+    /**
+     * @brief Insert a value that has already been hashed with a well mixed 64-bit hash
+     */
+    void insert_hash(std::uint64_t hash) {
+        const auto index = static_cast<std::uint32_t>(hash >> (64 - precision_));
+        // The guard bit bounds the rank when all remaining bits are zero.
+        const auto rest = (hash << precision_) | (std::uint64_t(1) << (precision_ - 1));
+        set_register(index, static_cast<std::uint8_t>(detail::countl_zero(rest) + 1));
+    }
+
+    /**
+     * @brief Merge the strings counted by `other` into this sketch
+     *
+     * @note Throws `std::invalid_argument` if the precisions differ.
+     */
+    void merge(const hyperloglog& other) {
+        if (other.precision_ != precision_) {
+            throw std::invalid_argument("Cannot merge HyperLogLog sketches of different precision");
+        }
+        if (other.is_sparse()) {
+            for (auto entry: other.sparse_) {
+                set_register(entry >> 8, static_cast<std::uint8_t>(entry & 0xFF));
+            }
+            return;
+        }
+        if (is_sparse()) {
+            to_dense();
+        }
+        // Branch-free so the compiler can merge many registers per instruction.
+        auto* dest = registers_.data();
+        const auto* src = other.registers_.data();
+        for (size_type i = 0; i < registers_.size(); ++i) {
+            dest[i] = dest[i] < src[i] ? src[i] : dest[i];
+        }
+    }
+
+    /**
+     * @brief Estimate the number of distinct strings inserted
+     */
+    [[nodiscard]] double estimate() const noexcept {
+        const auto m = static_cast<double>(num_registers());
+        double sum = 0;
+        size_type zeros = 0;
+        if (is_sparse()) {
+            zeros = num_registers() - sparse_.size();
+            sum = static_cast<double>(zeros);
+            for (auto entry: sparse_) {
+                sum += std::ldexp(1.0, -static_cast<int>(entry & 0xFF));
+            }
+        }
+        else {
+            for (auto r: registers_) {
+                sum += std::ldexp(1.0, -static_cast<int>(r));
+                zeros += r == 0;
+            }
+        }
+        double alpha = 0.7213 / (1 + 1.079 / m);
+        if (precision_ == 4) {
+            alpha = 0.673;
+        }
+        else if (precision_ == 5) {
+            alpha = 0.697;
+        }
+        else if (precision_ == 6) {
+            alpha = 0.709;
+        }
+        const auto raw = alpha * m * m / sum;
+        if (raw <= 2.5 * m && zeros != 0) {
+            // Linear counting is more accurate while many registers are unset.
+            return m * std::log(m / static_cast<double>(zeros));
+        }
+        return raw;
+    }
+};
+}// namespace andwass
@@ -0,0 +1,130 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace andwass {
+/**
+ * @brief A 0-based line and column pair
+ */
+struct line_column {
+    std::size_t line = 0;
+    std::size_t column = 0;
+
+    friend constexpr bool operator==(const line_column& lhs, const line_column& rhs) noexcept {
+        return lhs.line == rhs.line && lhs.column == rhs.column;
+    }
+
+    friend constexpr bool operator!=(const line_column& lhs, const line_column& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+};
+
+/**
+ * @brief Maps byte offsets in a text to lines and columns, and lines back to views.
+ *
+ * The text is scanned for `'\n'` once on construction. Lines are split on `'\n'` only,
+ * and the views returned by `line()` do not include the terminating newline. A text ending
+ * with a newline has an empty last line.
+ *
+ * @note The index does not own the text, the text must outlive the index.
+ */
+class line_index {
+    string_view text_;
+    std::vector<std::size_t> line_starts_;
+public:
+    using size_type = std::size_t;
+
+    /**
+     * @brief Build the index for a text
+     * @param text The text to index
+     */
+    explicit line_index(string_view text): text_(text) {
+        line_starts_.reserve(text.count('\n') + 1);
+        line_starts_.push_back(0);
+        for(auto pos = text.find('\n'); pos != string_view::npos; pos = text.find('\n')) {
+            line_starts_.push_back(line_starts_.back() + pos + 1);
+            text.remove_prefix(pos + 1);
+        }
+    }
+
+    /**
+     * @brief Get the indexed text
+     */
+    [[nodiscard]] string_view text() const noexcept {
+        return text_;
+    }
+
+    /**
+     * @brief Get the number of lines in the text
+     * @return The number of newlines plus one.
+     */
+    [[nodiscard]] size_type line_count() const noexcept {
+        return line_starts_.size();
+    }
+
+    /**
+     * @brief Get the offset of the first character of a line
+     * @param line 0-based line number
+     * @return The offset of the start of `line`.
+     *
+     * @note Throws `std::out_of_range` if `line >= line_count()`
+     */
+    [[nodiscard]] size_type line_start(size_type line) const {
+        return line_starts_.at(line);
+    }
+
+    /**
+     * @brief Get a view of a line, excluding the terminating newline
+     * @param line 0-based line number
+     * @return A view of `line`.
+     *
+     * @note Throws `std::out_of_range` if `line >= line_count()`
+     */
+    [[nodiscard]] string_view line(size_type line) const {
+        const auto start = line_start(line);
+        if (line + 1 < line_starts_.size()) {
+            return text_.substr(start, line_starts_[line + 1] - start - 1);
+        }
+        return text_.substr(start);
+    }
+
+    /**
+     * @brief Convert a byte offset to a line and column
+     * @param offset Byte offset into the text, `offset == text().size()` is allowed.
+     * @return The 0-based line and column of `offset`.
+     *
+     * A newline belongs to the line it terminates. The lookup is a binary search over the line starts.
+     *
+     * @note Throws `std::out_of_range` if `offset > text().size()`
+     */
+    [[nodiscard]] line_column position(size_type offset) const {
+        if (offset > text_.size()) {
+            throw std::out_of_range("Offset out of range");
+        }
+        const auto next_line = std::upper_bound(line_starts_.begin(), line_starts_.end(), offset);
+        const auto line = static_cast<size_type>(next_line - line_starts_.begin()) - 1;
+        return {line, offset - line_starts_[line]};
+    }
+
+    /**
+     * @brief Convert a line and column to a byte offset
+     * @param pos 0-based line and column
+     * @return The byte offset of `pos`, or `string_view::npos` if the position is outside the text.
+     */
+    [[nodiscard]] size_type offset(line_column pos) const noexcept {
+        if (pos.line >= line_starts_.size() || pos.column > line(pos.line).size()) {
+            return string_view::npos;
+        }
+        return line_starts_[pos.line] + pos.column;
+    }
+};
+}// namespace andwass
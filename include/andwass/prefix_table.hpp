@@ -0,0 +1,90 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/radix_tree.hpp>
+
+#include <utility>
+
+namespace andwass {
+/**
+ * @brief Maps registered prefixes to values and finds the longest registered prefix of a key
+ *
+ * Useful for routing tables and namespace resolution. The prefixes are stored in a
+ * `radix_tree`, so a lookup is a single descent that remembers the last prefix passed on
+ * the way down.
+ */
+template<class V>
+class prefix_table {
+    radix_tree<V> tree_;
+public:
+    using size_type = std::size_t;
+
+    /**
+     * @brief The result of a lookup
+     */
+    struct match {
+        // The matched prefix, empty if nothing matched.
+        string_view prefix;
+        // The value of the matched prefix, `nullptr` if nothing matched.
+        const V* value = nullptr;
+
+        explicit operator bool() const noexcept {
+            return value != nullptr;
+        }
+    };
+
+    /**
+     * @brief Get the number of registered prefixes
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return tree_.size();
+    }
+
+    /**
+     * @brief Register a prefix, replacing the value of an existing one
+     * @return True if the prefix was not registered before.
+     */
+    template<class T>
+    bool insert(string_view prefix, T&& value) {
+        return tree_.insert_or_assign(prefix, std::forward<T>(value)).second;
+    }
+
+    /**
+     * @brief Get the value registered for exactly `prefix`
+     * @return A pointer to the value, or `nullptr` if `prefix` is not registered.
+     */
+    [[nodiscard]] const V* find(string_view prefix) const noexcept {
+        return tree_.find(prefix);
+    }
+
+    /**
+     * @brief Find the longest registered prefix of a key
+     * @param key The key to look up
+     * @return The longest registered prefix of `key` and its value, or an empty match.
+     */
+    [[nodiscard]] match longest_match(string_view key) const noexcept {
+        const auto found = tree_.longest_prefix(key);
+        return {found.first, found.second};
+    }
+
+    /**
+     * @brief Find the longest registered prefix of many keys
+     * @param first, last A range of keys convertible to `string_view`
+     * @param out Receives a `match` for every key, in order.
+     *
+     * Independent lookups are interleaved so their cache misses overlap, which is
+     * faster than calling `longest_match` in a loop for large tables.
+     */
+    template<class Iter, class Out>
+    Out match_batch(Iter first, Iter last, Out out) const {
+        tree_.longest_prefix_batch(first, last, [&](const std::pair<string_view, const V*>& found) {
+            *out++ = match{found.first, found.second};
+        });
+        return out;
+    }
+};
+}// namespace andwass
@@ -0,0 +1,196 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+namespace andwass {
+/**
+ * @brief A 16 byte string view with the first chars stored inline ("German string")
+ *
+ * Layout: a 32-bit size followed by 12 bytes. Strings of at most 12 chars are stored
+ * entirely inline. Longer strings store their first 4 chars inline followed by a pointer
+ * to the full string, which is not owned.
+ *
+ * Size and prefix are compared together as one 8 byte word, so most unequal views are
+ * told apart without touching out-of-line data, and short strings never leave the object.
+ *
+ * Comparisons order bytes as `unsigned char`, like `std::memcmp`.
+ *
+ * @note `data()` of an inline view points into the object itself, views obtained
+ * from it are only valid while the `prefixed_view` is alive and unmodified.
+ */
+class prefixed_view {
+public:
+    using size_type = std::size_t;
+
+    static constexpr size_type max_inline_size = 12;
+    static constexpr size_type prefix_size = 4;
+
+private:
+    std::uint32_t size_ = 0;
+    // All chars if inline, otherwise the prefix followed by the bytes of a pointer.
+    char data_[max_inline_size] = {};
+
+    [[nodiscard]] const char* pointer() const noexcept {
+        const char* ptr = nullptr;
+        std::memcpy(&ptr, data_ + prefix_size, sizeof(ptr));
+        return ptr;
+    }
+
+    [[nodiscard]] std::uint64_t head() const noexcept {
+        std::uint64_t word = 0;
+        std::memcpy(&word, static_cast<const void*>(this), sizeof(word));
+        return word;
+    }
+
+    [[nodiscard]] std::uint32_t big_endian_prefix() const noexcept {
+        return (std::uint32_t(static_cast<unsigned char>(data_[0])) << 24)
+            | (std::uint32_t(static_cast<unsigned char>(data_[1])) << 16)
+            | (std::uint32_t(static_cast<unsigned char>(data_[2])) << 8)
+            | std::uint32_t(static_cast<unsigned char>(data_[3]));
+    }
+
+public:
+    /**
+     * @brief Construct an empty view
+     */
+    prefixed_view() noexcept = default;
+
+    /**
+     * @brief Construct from a `string_view`
+     * @param sv The chars to view. Up to 12 chars are copied, longer views must outlive this object.
+     *
+     * @note Throws `std::length_error` if `sv.size()` does not fit in 32 bits.
+     */
+    prefixed_view(string_view sv) {
+        if (sv.size() > (std::numeric_limits<std::uint32_t>::max)()) {
+            throw std::length_error("View too long for prefixed_view");
+        }
+        size_ = static_cast<std::uint32_t>(sv.size());
+        if (sv.size() <= max_inline_size) {
+            if (!sv.is_empty()) {
+                std::memcpy(data_, sv.data(), sv.size());
+            }
+        }
+        else {
+            const char* ptr = sv.data();
+            std::memcpy(data_, ptr, prefix_size);
+            std::memcpy(data_ + prefix_size, &ptr, sizeof(ptr));
+        }
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] bool is_empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Check if the chars are stored inside the object
+     */
+    [[nodiscard]] bool is_inline() const noexcept {
+        return size_ <= max_inline_size;
+    }
+
+    [[nodiscard]] const char* data() const noexcept {
+        return is_inline() ? data_ : pointer();
+    }
+
+    /**
+     * @brief Get a `string_view` of the chars
+     */
+    [[nodiscard]] string_view view() const noexcept {
+        return string_view(data(), size());
+    }
+
+    operator string_view() const noexcept {
+        return view();
+    }
+
+    /**
+     * @brief Compare two views
+     * @return 0 if equal, a negative value if `this` orders before `right`, otherwise a positive value.
+     *
+     * The inline prefixes are compared first, the full strings only if they are equal.
+     */
+    [[nodiscard]] int compare(const prefixed_view& right) const noexcept {
+        const auto left_prefix = big_endian_prefix();
+        const auto right_prefix = right.big_endian_prefix();
+        if (left_prefix != right_prefix) {
+            return left_prefix < right_prefix ? -1 : 1;
+        }
+        return detail::compare_bytes(view(), right.view());
+    }
+
+    friend bool operator==(const prefixed_view& lhs, const prefixed_view& rhs) noexcept {
+        if (lhs.head() != rhs.head()) {
+            return false;
+        }
+        if (lhs.is_inline()) {
+            // Unused inline bytes are zero, so the rest can be compared as a word as well.
+            return std::memcmp(lhs.data_ + prefix_size, rhs.data_ + prefix_size, max_inline_size - prefix_size) == 0;
+        }
+        return std::memcmp(lhs.pointer() + prefix_size, rhs.pointer() + prefix_size, lhs.size_ - prefix_size) == 0;
+    }
+
+    friend bool operator!=(const prefixed_view& lhs, const prefixed_view& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    // Both operands convert to either type, so mixed comparisons need overloads of their own.
+    friend bool operator==(const prefixed_view& lhs, const string_view& rhs) noexcept {
+        return lhs.view() == rhs;
+    }
+
+    friend bool operator==(const string_view& lhs, const prefixed_view& rhs) noexcept {
+        return lhs == rhs.view();
+    }
+
+    friend bool operator!=(const prefixed_view& lhs, const string_view& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator!=(const string_view& lhs, const prefixed_view& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(const prefixed_view& lhs, const prefixed_view& rhs) noexcept {
+        return lhs.compare(rhs) < 0;
+    }
+
+    friend bool operator>(const prefixed_view& lhs, const prefixed_view& rhs) noexcept {
+        return rhs < lhs;
+    }
+
+    friend bool operator<=(const prefixed_view& lhs, const prefixed_view& rhs) noexcept {
+        return !(rhs < lhs);
+    }
+
+    friend bool operator>=(const prefixed_view& lhs, const prefixed_view& rhs) noexcept {
+        return !(lhs < rhs);
+    }
+};
+
+static_assert(sizeof(prefixed_view) == 16, "prefixed_view must be 16 bytes");
+}// namespace andwass
+
+namespace std {
+template<>
+struct hash<andwass::prefixed_view> {
+    [[nodiscard]] std::size_t operator()(const andwass::prefixed_view& pv) const noexcept {
+        return static_cast<std::size_t>(andwass::hash(pv.view()));
+    }
+};
+}// namespace std
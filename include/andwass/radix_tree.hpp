@@ -0,0 +1,890 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+#include <andwass/detail/bits.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace andwass {
+/**
+ * @brief An ordered map from strings to `V` implemented as an adaptive radix tree
+ *
+ * Inner nodes grow through four layouts depending on their number of children: 4 and 16
+ * sorted key bytes with a parallel child array, a 256-entry index into 48 children, and a
+ * plain 256-entry child array. Chains of single-child nodes are collapsed into a prefix
+ * stored in the node (path compression), and a leaf is stored as soon as its key is
+ * unique (lazy expansion), so lookups only touch a few cache lines. Erasing shrinks nodes
+ * back to smaller layouts and merges a node left with a single child into that child.
+ *
+ * Keys are copied into the tree. Iteration is in `std::memcmp` order of the keys, i.e.
+ * bytes compare as `unsigned char`.
+ */
+template<class V>
+class radix_tree {
+public:
+    using size_type = std::size_t;
+    using mapped_type = V;
+
+private:
+    enum class node_kind : std::uint8_t {
+        leaf,
+        node4,
+        node16,
+        node48,
+        node256
+    };
+
+    struct node {
+        node_kind kind;
+        explicit node(node_kind k) noexcept: kind(k) {}
+    };
+
+    struct leaf: node {
+        std::string key;
+        V value;
+
+        template<class... Args>
+        leaf(string_view k, Args&&... args): node(node_kind::leaf), key(k.data(), k.size()), value(std::forward<Args>(args)...) {}
+
+        [[nodiscard]] string_view key_view() const noexcept {
+            return string_view(key.data(), key.size());
+        }
+    };
+
+    struct inner: node {
+        // Compressed path, the bytes between the edge into this node and its children.
+        std::string prefix;
+        // The leaf whose key ends exactly at this node, if any.
+        leaf* terminal = nullptr;
+        std::uint16_t count = 0;
+        explicit inner(node_kind k) noexcept: node(k) {}
+    };
+
+    struct node4: inner {
+        unsigned char keys[4] = {};
+        node* children[4] = {};
+        node4() noexcept: inner(node_kind::node4) {}
+    };
+
+    struct node16: inner {
+        unsigned char keys[16] = {};
+        node* children[16] = {};
+        node16() noexcept: inner(node_kind::node16) {}
+    };
+
+    struct node48: inner {
+        // 0 means no child, otherwise the child is children[index - 1].
+        std::uint8_t index[256] = {};
+        node* children[48] = {};
+        node48() noexcept: inner(node_kind::node48) {}
+    };
+
+    struct node256: inner {
+        node* children[256] = {};
+        node256() noexcept: inner(node_kind::node256) {}
+    };
+
+    node* root_ = nullptr;
+    size_type size_ = 0;
+
+    static void destroy(node* n) noexcept {
+        if (!n) {
+            return;
+        }
+        if (n->kind == node_kind::leaf) {
+            delete static_cast<leaf*>(n);
+            return;
+        }
+        for_each_child(static_cast<inner*>(n), [](unsigned char, node* child) {
+            destroy(child);
+        });
+        auto* in = static_cast<inner*>(n);
+        delete in->terminal;
+        delete_inner(in);
+    }
+
+    /**
+     * @brief Delete an inner node without its children and terminal
+     */
+    static void delete_inner(inner* n) noexcept {
+        switch (n->kind) {
+        case node_kind::node4: delete static_cast<node4*>(n); break;
+        case node_kind::node16: delete static_cast<node16*>(n); break;
+        case node_kind::node48: delete static_cast<node48*>(n); break;
+        default: delete static_cast<node256*>(n); break;
+        }
+    }
+
+    struct inner_deleter {
+        void operator()(inner* n) const noexcept {
+            delete_inner(n);
+        }
+    };
+
+    // `inner` has no virtual destructor, so owning pointers must delete through `delete_inner`.
+    using inner_ptr = std::unique_ptr<inner, inner_deleter>;
+
+    /**
+     * @brief Call `f(byte, child)` for every child in ascending byte order.
+     */
+    template<class F>
+    static void for_each_child(inner* n, F&& f) {
+        switch (n->kind) {
+        case node_kind::node4: {
+            auto* n4 = static_cast<node4*>(n);
+            for (unsigned i = 0; i < n->count; i++) {
+                f(n4->keys[i], n4->children[i]);
+            }
+            break;
+        }
+        case node_kind::node16: {
+            auto* n16 = static_cast<node16*>(n);
+            for (unsigned i = 0; i < n->count; i++) {
+                f(n16->keys[i], n16->children[i]);
+            }
+            break;
+        }
+        case node_kind::node48: {
+            auto* n48 = static_cast<node48*>(n);
+            for (unsigned b = 0; b < 256; b++) {
+                if (n48->index[b] != 0) {
+                    f(static_cast<unsigned char>(b), n48->children[n48->index[b] - 1]);
+                }
+            }
+            break;
+        }
+        default: {
+            auto* n256 = static_cast<node256*>(n);
+            for (unsigned b = 0; b < 256; b++) {
+                if (n256->children[b]) {
+                    f(static_cast<unsigned char>(b), n256->children[b]);
+                }
+            }
+            break;
+        }
+        }
+    }
+
+    static node** find_child(inner* n, unsigned char byte) noexcept {
+        switch (n->kind) {
+        case node_kind::node4: {
+            auto* n4 = static_cast<node4*>(n);
+            for (unsigned i = 0; i < n->count; i++) {
+                if (n4->keys[i] == byte) {
+                    return &n4->children[i];
+                }
+            }
+            return nullptr;
+        }
+        case node_kind::node16: {
+            auto* n16 = static_cast<node16*>(n);
+            // Compare all 16 keys without early exit so the loop is vectorized.
+            std::uint32_t matches = 0;
+            for (unsigned i = 0; i < 16; i++) {
+                matches |= static_cast<std::uint32_t>(n16->keys[i] == byte) << i;
+            }
+            matches &= (std::uint32_t(1) << n->count) - 1;
+            return matches ? &n16->children[detail::countr_zero(matches)] : nullptr;
+        }
+        case node_kind::node48: {
+            auto* n48 = static_cast<node48*>(n);
+            return n48->index[byte] ? &n48->children[n48->index[byte] - 1] : nullptr;
+        }
+        default: {
+            auto* n256 = static_cast<node256*>(n);
+            return n256->children[byte] ? &n256->children[byte] : nullptr;
+        }
+        }
+    }
+
+    template<class Small>
+    static void insert_sorted(Small* n, unsigned char byte, node* child) noexcept {
+        unsigned pos = 0;
+        while (pos < n->count && n->keys[pos] < byte) {
+            ++pos;
+        }
+        for (unsigned i = n->count; i > pos; --i) {
+            n->keys[i] = n->keys[i - 1];
+            n->children[i] = n->children[i - 1];
+        }
+        n->keys[pos] = byte;
+        n->children[pos] = child;
+        ++n->count;
+    }
+
+    template<class To, class From>
+    static To* grow_header(From* from) {
+        auto* to = new To();
+        to->prefix = std::move(from->prefix);
+        to->terminal = from->terminal;
+        return to;
+    }
+
+    /**
+     * @brief Add a child to the inner node at `ref`, replacing it with a larger node if full.
+     */
+    static void add_child(node*& ref, unsigned char byte, node* child) {
+        auto* n = static_cast<inner*>(ref);
+        switch (n->kind) {
+        case node_kind::node4: {
+            auto* n4 = static_cast<node4*>(n);
+            if (n->count < 4) {
+                insert_sorted(n4, byte, child);
+                return;
+            }
+            auto* n16 = grow_header<node16>(n4);
+            std::copy(n4->keys, n4->keys + 4, n16->keys);
+            std::copy(n4->children, n4->children + 4, n16->children);
+            n16->count = 4;
+            insert_sorted(n16, byte, child);
+            delete n4;
+            ref = n16;
+            return;
+        }
+        case node_kind::node16: {
+            auto* n16 = static_cast<node16*>(n);
+            if (n->count < 16) {
+                insert_sorted(n16, byte, child);
+                return;
+            }
+            auto* n48 = grow_header<node48>(n16);
+            for (unsigned i = 0; i < 16; i++) {
+                n48->children[i] = n16->children[i];
+                n48->index[n16->keys[i]] = static_cast<std::uint8_t>(i + 1);
+            }
+            n48->count = 16;
+            delete n16;
+            ref = n48;
+            add_child(ref, byte, child);
+            return;
+        }
+        case node_kind::node48: {
+            auto* n48 = static_cast<node48*>(n);
+            if (n->count < 48) {
+                unsigned slot = 0;
+                while (n48->children[slot]) {
+                    ++slot;
+                }
+                n48->children[slot] = child;
+                n48->index[byte] = static_cast<std::uint8_t>(slot + 1);
+                ++n->count;
+                return;
+            }
+            auto* n256 = grow_header<node256>(n48);
+            for (unsigned b = 0; b < 256; b++) {
+                if (n48->index[b]) {
+                    n256->children[b] = n48->children[n48->index[b] - 1];
+                }
+            }
+            n256->count = 48;
+            delete n48;
+            ref = n256;
+            add_child(ref, byte, child);
+            return;
+        }
+        default: {
+            auto* n256 = static_cast<node256*>(n);
+            n256->children[byte] = child;
+            ++n->count;
+            return;
+        }
+        }
+    }
+
+    static void remove_child(inner* n, unsigned char byte) noexcept {
+        switch (n->kind) {
+        case node_kind::node4:
+        case node_kind::node16: {
+            auto* keys = n->kind == node_kind::node4 ? static_cast<node4*>(n)->keys : static_cast<node16*>(n)->keys;
+            auto* children = n->kind == node_kind::node4 ? static_cast<node4*>(n)->children : static_cast<node16*>(n)->children;
+            unsigned pos = 0;
+            while (keys[pos] != byte) {
+                ++pos;
+            }
+            for (unsigned i = pos + 1; i < n->count; ++i) {
+                keys[i - 1] = keys[i];
+                children[i - 1] = children[i];
+            }
+            break;
+        }
+        case node_kind::node48: {
+            auto* n48 = static_cast<node48*>(n);
+            n48->children[n48->index[byte] - 1] = nullptr;
+            n48->index[byte] = 0;
+            break;
+        }
+        default:
+            static_cast<node256*>(n)->children[byte] = nullptr;
+            break;
+        }
+        --n->count;
+    }
+
+    /**
+     * @brief Allocate the smaller layout `n` shrinks to once it has `children` children, if any
+     *
+     * Nodes shrink well below the size they grow at, so alternating inserts and erases
+     * do not reallocate a node every time.
+     */
+    static inner_ptr shrunk_node(const inner* n, size_type children) {
+        switch (n->kind) {
+        case node_kind::node16: return children <= 3 ? inner_ptr(new node4()) : nullptr;
+        case node_kind::node48: return children <= 12 ? inner_ptr(new node16()) : nullptr;
+        case node_kind::node256: return children <= 37 ? inner_ptr(new node48()) : nullptr;
+        default: return nullptr;
+        }
+    }
+
+    /**
+     * @brief Remove the leaf of `key` from the inner node at `ref`
+     * @param child The byte of the leaf's edge, unused if the leaf is the terminal of the node.
+     *
+     * A node left with a single entry is replaced by it, and a node with few children by a
+     * smaller layout. Everything that allocates is done before the tree is modified, so if
+     * it throws the tree is unchanged.
+     */
+    void erase_from(node*& ref, bool terminal, unsigned char child) {
+        auto* in = static_cast<inner*>(ref);
+        leaf* erased = terminal ? in->terminal : static_cast<leaf*>(*find_child(in, child));
+        const size_type children = in->count - (terminal ? 0 : 1);
+        const bool keeps_terminal = !terminal && in->terminal;
+
+        if (children + (keeps_terminal ? 1 : 0) == 1) {
+            node* only = in->terminal;
+            std::string merged;
+            if (!keeps_terminal) {
+                for_each_child(in, [&](unsigned char byte, node* n) {
+                    if (terminal || byte != child) {
+                        only = n;
+                        if (n->kind != node_kind::leaf) {
+                            // The edge byte and both compressed paths become the path of the child.
+                            merged.reserve(in->prefix.size() + 1 + static_cast<inner*>(n)->prefix.size());
+                            merged += in->prefix;
+                            merged.push_back(static_cast<char>(byte));
+                            merged += static_cast<inner*>(n)->prefix;
+                        }
+                    }
+                });
+            }
+            if (only->kind != node_kind::leaf) {
+                static_cast<inner*>(only)->prefix.swap(merged);
+            }
+            delete erased;
+            delete_inner(in);
+            ref = only;
+            return;
+        }
+
+        auto smaller = shrunk_node(in, children);
+        if (terminal) {
+            in->terminal = nullptr;
+        }
+        else {
+            remove_child(in, child);
+        }
+        delete erased;
+        if (smaller) {
+            node* to = smaller.get();
+            for_each_child(in, [&](unsigned char byte, node* n) {
+                add_child(to, byte, n);
+            });
+            smaller->prefix.swap(in->prefix);
+            smaller->terminal = in->terminal;
+            delete_inner(in);
+            ref = smaller.release();
+        }
+    }
+
+    /**
+     * @brief Attach `l` to `n`, which has consumed `depth` bytes of the key.
+     */
+    static void attach(node*& n, leaf* l, size_type depth) {
+        auto* in = static_cast<inner*>(n);
+        if (l->key.size() == depth) {
+            in->terminal = l;
+        }
+        else {
+            add_child(n, static_cast<unsigned char>(l->key[depth]), l);
+        }
+    }
+
+    static size_type common_prefix(string_view lhs, string_view rhs) noexcept {
+        const auto n = (std::min)(lhs.size(), rhs.size());
+        size_type i = 0;
+        while (i < n && lhs[i] == rhs[i]) {
+            ++i;
+        }
+        return i;
+    }
+
+    template<class... Args>
+    std::pair<leaf*, bool> emplace_impl(string_view key, Args&&... args) {
+        node** ref = &root_;
+        size_type depth = 0;
+        while (true) {
+            node* n = *ref;
+            if (!n) {
+                auto* l = new leaf(key, std::forward<Args>(args)...);
+                *ref = l;
+                ++size_;
+                return {l, true};
+            }
+            // New leaves are owned by a `unique_ptr` until linked, in case allocating a node throws.
+            if (n->kind == node_kind::leaf) {
+                auto* existing = static_cast<leaf*>(n);
+                if (existing->key_view() == key) {
+                    return {existing, false};
+                }
+                // Replace the leaf by a node holding both keys.
+                std::unique_ptr<leaf> l(new leaf(key, std::forward<Args>(args)...));
+                const auto p = common_prefix(existing->key_view().substr(depth), key.substr(depth));
+                std::unique_ptr<node4> split(new node4());
+                split->prefix.assign(key.data() + depth, p);
+                node* split_node = split.get();
+                attach(split_node, existing, depth + p);
+                attach(split_node, l.get(), depth + p);
+                *ref = split.release();
+                ++size_;
+                return {l.release(), true};
+            }
+            auto* in = static_cast<inner*>(n);
+            const string_view prefix(in->prefix.data(), in->prefix.size());
+            const auto p = common_prefix(prefix, key.substr(depth));
+            if (p < prefix.size()) {
+                // The key leaves the compressed path, split it.
+                std::unique_ptr<leaf> l(new leaf(key, std::forward<Args>(args)...));
+                std::unique_ptr<node4> split(new node4());
+                split->prefix.assign(prefix.data(), p);
+                const auto byte = static_cast<unsigned char>(prefix[p]);
+                in->prefix.erase(0, p + 1);
+                node* split_node = split.get();
+                add_child(split_node, byte, in);
+                attach(split_node, l.get(), depth + p);
+                *ref = split.release();
+                ++size_;
+                return {l.release(), true};
+            }
+            depth += prefix.size();
+            if (depth == key.size()) {
+                if (in->terminal) {
+                    return {in->terminal, false};
+                }
+                in->terminal = new leaf(key, std::forward<Args>(args)...);
+                ++size_;
+                return {in->terminal, true};
+            }
+            const auto byte = static_cast<unsigned char>(key[depth]);
+            if (auto child = find_child(in, byte)) {
+                ref = child;
+                ++depth;
+                continue;
+            }
+            std::unique_ptr<leaf> l(new leaf(key, std::forward<Args>(args)...));
+            add_child(*ref, byte, l.get());
+            ++size_;
+            return {l.release(), true};
+        }
+    }
+
+    leaf* find_leaf(string_view key) const noexcept {
+        node* n = root_;
+        size_type depth = 0;
+        while (n) {
+            if (n->kind == node_kind::leaf) {
+                auto* l = static_cast<leaf*>(n);
+                return l->key_view() == key ? l : nullptr;
+            }
+            auto* in = static_cast<inner*>(n);
+            if (!key.substr(depth).starts_with(string_view(in->prefix.data(), in->prefix.size()))) {
+                return nullptr;
+            }
+            depth += in->prefix.size();
+            if (depth == key.size()) {
+                return in->terminal;
+            }
+            auto child = find_child(in, static_cast<unsigned char>(key[depth]));
+            n = child ? *child : nullptr;
+            ++depth;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief State of a longest prefix match descent, advanced one node at a time.
+     */
+    struct prefix_cursor {
+        string_view key;
+        node* n = nullptr;
+        size_type depth = 0;
+        leaf* best = nullptr;
+
+        // Returns false once the descent is finished.
+        bool step() noexcept {
+            if (n->kind == node_kind::leaf) {
+                auto* l = static_cast<leaf*>(n);
+                if (key.starts_with(l->key_view())) {
+                    best = l;
+                }
+                n = nullptr;
+                return false;
+            }
+            auto* in = static_cast<inner*>(n);
+            if (!key.substr(depth).starts_with(string_view(in->prefix.data(), in->prefix.size()))) {
+                n = nullptr;
+                return false;
+            }
+            depth += in->prefix.size();
+            if (in->terminal) {
+                best = in->terminal;
+            }
+            if (depth == key.size()) {
+                n = nullptr;
+                return false;
+            }
+            auto child = find_child(in, static_cast<unsigned char>(key[depth]));
+            n = child ? *child : nullptr;
+            ++depth;
+            if (n) {
+                detail::prefetch(n);
+            }
+            return n != nullptr;
+        }
+
+        [[nodiscard]] std::pair<string_view, const V*> result() const noexcept {
+            if (!best) {
+                return {string_view(), nullptr};
+            }
+            return {best->key_view(), &best->value};
+        }
+    };
+
+    template<class F>
+    static void visit(node* n, F& f) {
+        if (n->kind == node_kind::leaf) {
+            f(static_cast<leaf*>(n));
+            return;
+        }
+        auto* in = static_cast<inner*>(n);
+        if (in->terminal) {
+            f(in->terminal);
+        }
+        for_each_child(in, [&](unsigned char, node* child) {
+            visit(child, f);
+        });
+    }
+
+    template<class F>
+    static void visit_range(node* n, std::string& path, string_view first, string_view last, F& f) {
+        auto in_range = [&](leaf* l) {
+            const auto key = l->key_view();
+            return detail::compare_bytes(key, first) >= 0 && detail::compare_bytes(key, last) < 0;
+        };
+        if (n->kind == node_kind::leaf) {
+            if (in_range(static_cast<leaf*>(n))) {
+                f(static_cast<leaf*>(n));
+            }
+            return;
+        }
+        auto* in = static_cast<inner*>(n);
+        const auto path_size = path.size();
+        path += in->prefix;
+        // Every key below starts with `path`, skip the subtree if all of them are out of range.
+        const string_view p(path.data(), path.size());
+        const auto vs_last = detail::compare_bytes(p, last.substr(0, p.size()));
+        if (detail::compare_bytes(p, first.substr(0, p.size())) >= 0 && (vs_last < 0 || (vs_last == 0 && p.size() < last.size()))) {
+            if (in->terminal && in_range(in->terminal)) {
+                f(in->terminal);
+            }
+            for_each_child(in, [&](unsigned char byte, node* child) {
+                path.push_back(static_cast<char>(byte));
+                visit_range(child, path, first, last, f);
+                path.pop_back();
+            });
+        }
+        path.resize(path_size);
+    }
+
+    template<class F>
+    static void for_each_prefix_impl(node* n, string_view prefix, F& f) {
+        size_type depth = 0;
+        while (n) {
+            if (depth == prefix.size()) {
+                visit(n, f);
+                return;
+            }
+            if (n->kind == node_kind::leaf) {
+                if (static_cast<leaf*>(n)->key_view().starts_with(prefix)) {
+                    f(static_cast<leaf*>(n));
+                }
+                return;
+            }
+            auto* in = static_cast<inner*>(n);
+            const string_view node_prefix(in->prefix.data(), in->prefix.size());
+            const auto rest = prefix.substr(depth);
+            if (rest.size() <= node_prefix.size()) {
+                if (node_prefix.starts_with(rest)) {
+                    visit(n, f);
+                }
+                return;
+            }
+            if (!rest.starts_with(node_prefix)) {
+                return;
+            }
+            depth += node_prefix.size();
+            auto child = find_child(in, static_cast<unsigned char>(prefix[depth]));
+            n = child ? *child : nullptr;
+            ++depth;
+        }
+    }
+
+public:
+    radix_tree() = default;
+
+    radix_tree(const radix_tree&) = delete;
+    radix_tree& operator=(const radix_tree&) = delete;
+
+    radix_tree(radix_tree&& rhs) noexcept: root_(std::exchange(rhs.root_, nullptr)), size_(std::exchange(rhs.size_, 0)) {}
+
+    radix_tree& operator=(radix_tree&& rhs) noexcept {
+        if (this != &rhs) {
+            clear();
+            root_ = std::exchange(rhs.root_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    ~radix_tree() {
+        clear();
+    }
+
+    /**
+     * @brief Get the number of keys in the tree
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] bool is_empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Remove all keys
+     */
+    void clear() noexcept {
+        destroy(root_);
+        root_ = nullptr;
+        size_ = 0;
+    }
+
+    /**
+     * @brief Insert a key if it is not already present
+     * @param key The key, copied into the tree.
+     * @param args Arguments to construct the value with, only used if the key is inserted.
+     * @return A pointer to the value of `key`, and true if it was inserted.
+     */
+    template<class... Args>
+    std::pair<V*, bool> try_emplace(string_view key, Args&&... args) {
+        auto retval = emplace_impl(key, std::forward<Args>(args)...);
+        return {&retval.first->value, retval.second};
+    }
+
+    /**
+     * @brief Insert or assign the value of a key
+     * @return A pointer to the value of `key`, and true if it was inserted.
+     */
+    template<class T>
+    std::pair<V*, bool> insert_or_assign(string_view key, T&& value) {
+        auto retval = emplace_impl(key, std::forward<T>(value));
+        if (!retval.second) {
+            retval.first->value = std::forward<T>(value);
+        }
+        return {&retval.first->value, retval.second};
+    }
+
+    /**
+     * @brief Get the value of a key, inserting a default constructed value if missing
+     */
+    V& operator[](string_view key) {
+        return emplace_impl(key).first->value;
+    }
+
+    /**
+     * @brief Find the value of a key
+     * @return A pointer to the value, or `nullptr` if `key` is not in the tree.
+     */
+    [[nodiscard]] V* find(string_view key) noexcept {
+        auto* l = find_leaf(key);
+        return l ? &l->value : nullptr;
+    }
+
+    [[nodiscard]] const V* find(string_view key) const noexcept {
+        auto* l = find_leaf(key);
+        return l ? &l->value : nullptr;
+    }
+
+    [[nodiscard]] bool contains(string_view key) const noexcept {
+        return find_leaf(key) != nullptr;
+    }
+
+    /**
+     * @brief Remove a key
+     * @return true if `key` was in the tree.
+     *
+     * @note May throw `std::bad_alloc` when shrinking a node or merging paths, the tree is
+     * unchanged in that case.
+     */
+    bool erase(string_view key) {
+        if (!root_) {
+            return false;
+        }
+        if (root_->kind == node_kind::leaf) {
+            if (static_cast<leaf*>(root_)->key_view() != key) {
+                return false;
+            }
+            delete static_cast<leaf*>(root_);
+            root_ = nullptr;
+            --size_;
+            return true;
+        }
+        node** ref = &root_;
+        size_type depth = 0;
+        while (true) {
+            auto* in = static_cast<inner*>(*ref);
+            if (!key.substr(depth).starts_with(string_view(in->prefix.data(), in->prefix.size()))) {
+                return false;
+            }
+            depth += in->prefix.size();
+            if (depth == key.size()) {
+                if (!in->terminal) {
+                    return false;
+                }
+                erase_from(*ref, true, 0);
+                --size_;
+                return true;
+            }
+            const auto byte = static_cast<unsigned char>(key[depth]);
+            auto child = find_child(in, byte);
+            if (!child) {
+                return false;
+            }
+            if ((*child)->kind == node_kind::leaf) {
+                if (static_cast<leaf*>(*child)->key_view() != key) {
+                    return false;
+                }
+                erase_from(*ref, false, byte);
+                --size_;
+                return true;
+            }
+            ref = child;
+            ++depth;
+        }
+    }
+
+    /**
+     * @brief Find the longest key that is a prefix of `key`
+     * @return A view of the found key and a pointer to its value, or `nullptr` as the value if no key is a prefix of `key`.
+     */
+    [[nodiscard]] std::pair<string_view, const V*> longest_prefix(string_view key) const noexcept {
+        prefix_cursor cursor{key, root_};
+        if (cursor.n) {
+            while (cursor.step()) {
+            }
+        }
+        return cursor.result();
+    }
+
+    /**
+     * @brief Find the longest prefix of many keys
+     * @param first, last A range of keys convertible to `string_view`
+     * @param f Called with the result of `longest_prefix` for every key, in order.
+     *
+     * Up to 8 descents are interleaved, each advancing one node per round with a prefetch
+     * of its next node, so the cache misses of independent lookups overlap.
+     */
+    template<class Iter, class F>
+    void longest_prefix_batch(Iter first, Iter last, F&& f) const {
+        constexpr size_type batch_size = 8;
+        prefix_cursor cursors[batch_size];
+        while (first != last) {
+            size_type count = 0;
+            for (; count < batch_size && first != last; ++count, ++first) {
+                cursors[count] = prefix_cursor{string_view(*first), root_};
+            }
+            for (bool active = true; active;) {
+                active = false;
+                for (size_type i = 0; i < count; i++) {
+                    if (cursors[i].n) {
+                        active = cursors[i].step() || active;
+                    }
+                }
+            }
+            for (size_type i = 0; i < count; i++) {
+                f(cursors[i].result());
+            }
+        }
+    }
+
+    /**
+     * @brief Call `f(key, value)` for every key in ascending order
+     */
+    template<class F>
+    void for_each(F&& f) const {
+        auto call = [&](leaf* l) {
+            f(l->key_view(), static_cast<const V&>(l->value));
+        };
+        if (root_) {
+            visit(root_, call);
+        }
+    }
+
+    template<class F>
+    void for_each(F&& f) {
+        auto call = [&](leaf* l) {
+            f(l->key_view(), l->value);
+        };
+        if (root_) {
+            visit(root_, call);
+        }
+    }
+
+    /**
+     * @brief Call `f(key, value)` for every key starting with `prefix`, in ascending order
+     *
+     * Only the subtree below `prefix` is visited.
+     */
+    template<class F>
+    void for_each_prefix(string_view prefix, F&& f) const {
+        auto call = [&](leaf* l) {
+            f(l->key_view(), static_cast<const V&>(l->value));
+        };
+        for_each_prefix_impl(root_, prefix, call);
+    }
+
+    /**
+     * @brief Call `f(key, value)` for every key in `[first, last)`, in ascending order
+     *
+     * Subtrees entirely outside of the range are skipped.
+     */
+    template<class F>
+    void for_each_range(string_view first, string_view last, F&& f) const {
+        auto call = [&](leaf* l) {
+            f(l->key_view(), static_cast<const V&>(l->value));
+        };
+        if (root_) {
+            std::string path;
+            visit_range(root_, path, first, last, call);
+        }
+    }
+};
+}// namespace andwass
@@ -0,0 +1,416 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace andwass {
+namespace detail
+{
+/**
+ * @brief Thompson NFA built from a regex subset.
+ *
+ * States either consume one char from a set, or are epsilon splits to up to two
+ * other states. State 0 is the single accepting state.
+ */
+class regex_nfa {
+public:
+    static constexpr int none = -1;
+
+    struct state {
+        int char_set = none; // index into `char_sets`, `none` for epsilon states
+        int out = none;
+        int out2 = none;
+    };
+
+    std::vector<state> states;
+    std::vector<std::bitset<256>> char_sets;
+    int start = 0;
+    bool anchored_start = false;
+    bool anchored_end = false;
+
+    explicit regex_nfa(string_view pattern): pattern_(pattern) {
+        states.push_back(state{}); // accepting state
+        if (pattern_.starts_with("^")) {
+            anchored_start = true;
+            pattern_.remove_prefix(1);
+        }
+        if (pattern_.ends_with("$") && !ends_with_escape(pattern_)) {
+            anchored_end = true;
+            pattern_.remove_suffix(1);
+        }
+        auto frag = parse_alternation();
+        if (!pattern_.is_empty()) {
+            throw std::invalid_argument("Unmatched ')' in regex");
+        }
+        patch(frag.outs, 0);
+        start = frag.start;
+    }
+
+private:
+    // A partially built automaton, `outs` are the dangling out edges as `state * 2 + which`.
+    struct fragment {
+        int start;
+        std::vector<int> outs;
+    };
+
+    string_view pattern_;
+
+    static bool ends_with_escape(string_view pattern) noexcept {
+        // Count the backslashes before the final '$'.
+        std::size_t n = 0;
+        while (n + 1 < pattern.size() && pattern[pattern.size() - 2 - n] == '\\') {
+            ++n;
+        }
+        return n % 2 == 1;
+    }
+
+    int add_state(int char_set, int out, int out2) {
+        states.push_back(state{char_set, out, out2});
+        return static_cast<int>(states.size() - 1);
+    }
+
+    fragment char_fragment(const std::bitset<256>& set) {
+        char_sets.push_back(set);
+        const auto s = add_state(static_cast<int>(char_sets.size() - 1), none, none);
+        return {s, {s * 2}};
+    }
+
+    void patch(const std::vector<int>& outs, int target) noexcept {
+        for (auto out: outs) {
+            auto& st = states[static_cast<std::size_t>(out / 2)];
+            (out % 2 == 0 ? st.out : st.out2) = target;
+        }
+    }
+
+    [[nodiscard]] bool at(char ch) const noexcept {
+        return !pattern_.is_empty() && pattern_.front() == ch;
+    }
+
+    char take() {
+        if (pattern_.is_empty()) {
+            throw std::invalid_argument("Unexpected end of regex");
+        }
+        return pattern_.remove_prefix(1).front();
+    }
+
+    fragment parse_alternation() {
+        auto frag = parse_concatenation();
+        while (at('|')) {
+            take();
+            auto rhs = parse_concatenation();
+            const auto split = add_state(none, frag.start, rhs.start);
+            frag.outs.insert(frag.outs.end(), rhs.outs.begin(), rhs.outs.end());
+            frag.start = split;
+        }
+        return frag;
+    }
+
+    fragment parse_concatenation() {
+        const auto empty = add_state(none, none, none);
+        fragment frag{empty, {empty * 2}};
+        while (!pattern_.is_empty() && !at('|') && !at(')')) {
+            auto next = parse_repetition();
+            patch(frag.outs, next.start);
+            frag.outs = std::move(next.outs);
+        }
+        return frag;
+    }
+
+    fragment parse_repetition() {
+        auto frag = parse_atom();
+        while (at('*') || at('+') || at('?')) {
+            const auto op = take();
+            const auto split = add_state(none, frag.start, none);
+            if (op == '*') {
+                patch(frag.outs, split);
+                frag = {split, {split * 2 + 1}};
+            }
+            else if (op == '+') {
+                patch(frag.outs, split);
+                frag.outs = {split * 2 + 1};
+            }
+            else {
+                frag.outs.push_back(split * 2 + 1);
+                frag.start = split;
+            }
+        }
+        return frag;
+    }
+
+    static std::bitset<256> escape_set(char ch) {
+        std::bitset<256> set;
+        auto add_range = [&](char lo, char hi) {
+            for (auto c = static_cast<unsigned char>(lo); c <= static_cast<unsigned char>(hi); c++) {
+                set.set(c);
+            }
+        };
+        switch (ch) {
+        case 'd': case 'D': add_range('0', '9'); break;
+        case 'w': case 'W': add_range('0', '9'); add_range('a', 'z'); add_range('A', 'Z'); set.set('_'); break;
+        case 's': case 'S': for (auto c: string_view(" \t\n\r\f\v")) { set.set(static_cast<unsigned char>(c)); } break;
+        case 'n': set.set('\n'); break;
+        case 't': set.set('\t'); break;
+        case 'r': set.set('\r'); break;
+        default: set.set(static_cast<unsigned char>(ch)); break;
+        }
+        if (ch == 'D' || ch == 'W' || ch == 'S') {
+            set.flip();
+        }
+        return set;
+    }
+
+    // Parse one (possibly escaped) char of a class, returns false if it was a multi-char escape.
+    bool parse_class_char(std::bitset<256>& set, unsigned char& ch) {
+        ch = static_cast<unsigned char>(take());
+        if (ch != '\\') {
+            return true;
+        }
+        const auto escaped = escape_set(take());
+        if (escaped.count() != 1) {
+            set |= escaped;
+            return false;
+        }
+        ch = 0;
+        while (!escaped.test(ch)) {
+            ++ch;
+        }
+        return true;
+    }
+
+    std::bitset<256> parse_class() {
+        std::bitset<256> set;
+        const bool negate = at('^');
+        if (negate) {
+            take();
+        }
+        // A ']' directly after the opening bracket is part of the class.
+        bool first = true;
+        while (first || !at(']')) {
+            first = false;
+            unsigned char lo = 0;
+            if (!parse_class_char(set, lo)) {
+                continue;
+            }
+            if (at('-') && pattern_.size() > 1 && pattern_[1] != ']') {
+                take();
+                unsigned char hi = 0;
+                if (!parse_class_char(set, hi) || hi < lo) {
+                    throw std::invalid_argument("Invalid range in regex character class");
+                }
+                for (unsigned c = lo; c <= hi; c++) {
+                    set.set(c);
+                }
+            }
+            else {
+                set.set(lo);
+            }
+        }
+        take();
+        return negate ? ~set : set;
+    }
+
+    fragment parse_atom() {
+        const auto ch = take();
+        switch (ch) {
+        case '(': {
+            auto frag = parse_alternation();
+            if (!at(')')) {
+                throw std::invalid_argument("Missing ')' in regex");
+            }
+            take();
+            return frag;
+        }
+        case '[':
+            return char_fragment(parse_class());
+        case '.':
+            return char_fragment(~std::bitset<256>().set('\n'));
+        case '\\':
+            return char_fragment(escape_set(take()));
+        case '*': case '+': case '?':
+            throw std::invalid_argument("Nothing to repeat in regex");
+        case '^': case '$':
+            throw std::invalid_argument("Anchors are only supported at the start and end of a regex");
+        default:
+            return char_fragment(std::bitset<256>().set(static_cast<unsigned char>(ch)));
+        }
+    }
+};
+}
+
+/**
+ * @brief A regular expression matched with a lazily built DFA
+ *
+ * Supported syntax: literal chars, `.` (any char but `'\n'`), classes such as `[a-z_]` and `[^0-9]`,
+ * the escapes `\d \w \s \D \W \S \n \t \r` and escaped metacharacters, grouping with `( )`,
+ * alternation `|` and the quantifiers `* + ?`. `^` and `$` anchor the whole expression when they
+ * are the first and last char of the pattern, respectively.
+ *
+ * The pattern is compiled to an NFA. DFA states are created from it on demand while matching
+ * and cached with a 256-entry transition row each, so once warm every char costs a single table
+ * lookup and matching never allocates. The cache holds at most `max_states` states, when it is
+ * full it is flushed and rebuilt from the current state, bounding memory for patterns with
+ * exponentially many DFA states. Matching is linear in the size of the text.
+ *
+ * @note Matching updates the state cache, so a `regex` must not be used from several threads concurrently.
+ */
+class regex {
+    static constexpr int unknown = -1;
+
+    struct dfa_cache {
+        std::vector<std::vector<int>> sets;
+        std::map<std::vector<int>, int> ids;
+        std::vector<int> transitions;
+        std::vector<char> accepting;
+        int start = unknown;
+        bool unanchored = false;
+    };
+
+    detail::regex_nfa nfa_;
+    std::size_t max_states_;
+    mutable dfa_cache anchored_;
+    mutable dfa_cache unanchored_;
+    mutable std::vector<unsigned> visited_;
+    mutable unsigned generation_ = 0;
+    mutable std::vector<int> stack_;
+
+    void add_closure(int nfa_state, std::vector<int>& set) const {
+        stack_.assign(1, nfa_state);
+        while (!stack_.empty()) {
+            const auto s = stack_.back();
+            stack_.pop_back();
+            if (s == detail::regex_nfa::none || visited_[static_cast<std::size_t>(s)] == generation_) {
+                continue;
+            }
+            visited_[static_cast<std::size_t>(s)] = generation_;
+            const auto& st = nfa_.states[static_cast<std::size_t>(s)];
+            if (st.char_set != detail::regex_nfa::none || s == 0) {
+                set.push_back(s);
+            }
+            else {
+                stack_.push_back(st.out2);
+                stack_.push_back(st.out);
+            }
+        }
+    }
+
+    void begin_set() const {
+        if (++generation_ == 0) {
+            std::fill(visited_.begin(), visited_.end(), 0u);
+            generation_ = 1;
+        }
+    }
+
+    int intern(dfa_cache& cache, std::vector<int> set, bool& flushed) const {
+        std::sort(set.begin(), set.end());
+        if (const auto found = cache.ids.find(set); found != cache.ids.end()) {
+            return found->second;
+        }
+        flushed = cache.sets.size() >= max_states_;
+        if (flushed) {
+            const auto unanchored = cache.unanchored;
+            cache = dfa_cache();
+            cache.unanchored = unanchored;
+        }
+        const auto id = static_cast<int>(cache.sets.size());
+        cache.accepting.push_back(std::binary_search(set.begin(), set.end(), 0) ? 1 : 0);
+        cache.transitions.resize(cache.transitions.size() + 256, unknown);
+        cache.ids.emplace(set, id);
+        cache.sets.push_back(std::move(set));
+        return id;
+    }
+
+    int start_state(dfa_cache& cache) const {
+        if (cache.start == unknown) {
+            begin_set();
+            std::vector<int> set;
+            add_closure(nfa_.start, set);
+            bool flushed = false;
+            cache.start = intern(cache, std::move(set), flushed);
+        }
+        return cache.start;
+    }
+
+    int step(dfa_cache& cache, int state, unsigned char ch) const {
+        const auto cached = cache.transitions[static_cast<std::size_t>(state) * 256 + ch];
+        if (cached != unknown) {
+            return cached;
+        }
+        begin_set();
+        std::vector<int> next;
+        for (auto s: cache.sets[static_cast<std::size_t>(state)]) {
+            const auto& st = nfa_.states[static_cast<std::size_t>(s)];
+            if (st.char_set != detail::regex_nfa::none && nfa_.char_sets[static_cast<std::size_t>(st.char_set)].test(ch)) {
+                add_closure(st.out, next);
+            }
+        }
+        if (cache.unanchored) {
+            add_closure(nfa_.start, next);
+        }
+        bool flushed = false;
+        const auto id = intern(cache, std::move(next), flushed);
+        // `state` no longer exists if the cache was flushed.
+        if (!flushed) {
+            cache.transitions[static_cast<std::size_t>(state) * 256 + ch] = id;
+        }
+        return id;
+    }
+
+    bool run(dfa_cache& cache, string_view text, bool stop_on_accept) const {
+        auto state = start_state(cache);
+        if (stop_on_accept && cache.accepting[static_cast<std::size_t>(state)]) {
+            return true;
+        }
+        for (auto ch: text) {
+            state = step(cache, state, static_cast<unsigned char>(ch));
+            if (cache.sets[static_cast<std::size_t>(state)].empty()) {
+                return false;
+            }
+            if (stop_on_accept && cache.accepting[static_cast<std::size_t>(state)]) {
+                return true;
+            }
+        }
+        return cache.accepting[static_cast<std::size_t>(state)] != 0;
+    }
+
+public:
+    /**
+     * @brief Compile a pattern
+     * @param pattern The pattern
+     * @param max_states Maximum number of cached DFA states per matching mode, at least 2.
+     *
+     * @note Throws `std::invalid_argument` if the pattern is malformed or unsupported.
+     */
+    explicit regex(string_view pattern, std::size_t max_states = 1024): nfa_(pattern), max_states_((std::max)(max_states, std::size_t(2))) {
+        visited_.assign(nfa_.states.size(), 0);
+        unanchored_.unanchored = !nfa_.anchored_start;
+    }
+
+    /**
+     * @brief Check if the whole text matches the pattern
+     * @param text The text to match
+     * @return True if all of `text` matches, regardless of anchors.
+     */
+    [[nodiscard]] bool match(string_view text) const {
+        return run(anchored_, text, false);
+    }
+
+    /**
+     * @brief Check if any part of the text matches the pattern
+     * @param text The text to search
+     * @return True if some substring of `text` matches, honouring `^` and `$`.
+     */
+    [[nodiscard]] bool search(string_view text) const {
+        return run(nfa_.anchored_start ? anchored_ : unanchored_, text, !nfa_.anchored_end);
+    }
+};
+}// namespace andwass
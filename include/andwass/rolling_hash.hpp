@@ -0,0 +1,264 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace andwass {
+/**
+ * @brief A polynomial hash of a fixed size window that can slide one char at a time
+ *
+ * The hash of `s[0, w)` is `s[0] * B^(w-1) + ... + s[w-1]` modulo `2^64`, with chars taken as
+ * `unsigned char`. Sliding the window removes the contribution of the first char and appends
+ * the next in O(1).
+ *
+ * The hash is not collision resistant against crafted input, so equal hashes must be
+ * verified by comparing the chars.
+ */
+class rolling_hash {
+public:
+    using size_type = std::size_t;
+
+    static constexpr std::uint64_t default_base = 0x100000001b3ull;
+
+private:
+    size_type window_;
+    std::uint64_t base_;
+    // base_^(window_ - 1), the weight of the first char in the window.
+    std::uint64_t top_ = 1;
+    std::uint64_t value_ = 0;
+
+public:
+    /**
+     * @brief Construct a hash for windows of `window` chars
+     * @param window The window size.
+     * @param base The polynomial base, should be odd and large.
+     */
+    constexpr explicit rolling_hash(size_type window, std::uint64_t base = default_base) noexcept: window_(window), base_(base) {
+        for (size_type i = 1; i < window; ++i) {
+            top_ *= base;
+        }
+    }
+
+    [[nodiscard]] constexpr size_type window_size() const noexcept {
+        return window_;
+    }
+
+    /**
+     * @brief Hash the first `window_size()` chars of `str`, without changing the current value
+     */
+    [[nodiscard]] constexpr std::uint64_t operator()(string_view str) const noexcept {
+        std::uint64_t h = 0;
+        const auto size = (std::min)(window_, str.size());
+        for (size_type i = 0; i < size; ++i) {
+            h = h * base_ + static_cast<unsigned char>(str[i]);
+        }
+        return h;
+    }
+
+    /**
+     * @brief Set the current window to the first `window_size()` chars of `str`
+     */
+    constexpr void reset(string_view str) noexcept {
+        value_ = (*this)(str);
+    }
+
+    /**
+     * @brief Slide the window one char
+     * @param out The first char of the current window.
+     * @param in The char following the current window.
+     */
+    constexpr void roll(char out, char in) noexcept {
+        value_ = (value_ - static_cast<unsigned char>(out) * top_) * base_ + static_cast<unsigned char>(in);
+    }
+
+    /**
+     * @brief Get the hash of the current window
+     */
+    [[nodiscard]] constexpr std::uint64_t value() const noexcept {
+        return value_;
+    }
+};
+
+/**
+ * @brief Search for many patterns of equal size at once with the Rabin-Karp algorithm
+ *
+ * The haystack is scanned once with a `rolling_hash`, independent of the number of patterns.
+ * Every window is first checked against a bit set of pattern hashes, which rejects almost all
+ * windows with a single memory access. Remaining windows are looked up in the sorted pattern
+ * hashes and verified with `operator==`.
+ *
+ * The patterns are copied into the searcher.
+ */
+class rabin_karp_searcher {
+public:
+    using size_type = std::size_t;
+
+    static constexpr size_type npos = string_view::npos;
+
+private:
+    struct entry {
+        std::uint64_t hash;
+        size_type id;
+    };
+
+    rolling_hash hash_;
+    std::vector<char> patterns_;
+    std::vector<entry> entries_;
+    std::vector<std::uint64_t> filter_;
+    unsigned filter_shift_ = 64;
+
+    [[nodiscard]] size_type filter_bit(std::uint64_t hash) const noexcept {
+        return static_cast<size_type>(detail::hash_mix(hash) >> filter_shift_);
+    }
+
+    void add(string_view pattern) {
+        if (pattern.size() != hash_.window_size()) {
+            throw std::invalid_argument("All patterns must have the same, non-zero, size");
+        }
+        patterns_.insert(patterns_.end(), pattern.data(), pattern.data() + pattern.size());
+    }
+
+    void build() {
+        const auto count = size();
+        entries_.reserve(count);
+        for (size_type id = 0; id < count; ++id) {
+            entries_.push_back(entry{hash_((*this)[id]), id});
+        }
+        std::sort(entries_.begin(), entries_.end(), [](const entry& lhs, const entry& rhs) {
+            return lhs.hash < rhs.hash || (lhs.hash == rhs.hash && lhs.id < rhs.id);
+        });
+        // Around 16 bits per pattern keeps the false positive rate of the filter near 6%.
+        unsigned bits = 6;
+        while ((size_type(1) << bits) < count * 16 && bits < 32) {
+            ++bits;
+        }
+        filter_shift_ = 64 - bits;
+        filter_.assign((size_type(1) << bits) / 64, 0);
+        for (const auto& e: entries_) {
+            const auto bit = filter_bit(e.hash);
+            filter_[bit / 64] |= std::uint64_t(1) << (bit % 64);
+        }
+    }
+
+    template<class F>
+    bool check_window(string_view haystack, size_type pos, std::uint64_t hash, F& f) const {
+        const auto bit = filter_bit(hash);
+        if (((filter_[bit / 64] >> (bit % 64)) & 1) == 0) {
+            return true;
+        }
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), hash, [](const entry& e, std::uint64_t h) {
+            return e.hash < h;
+        });
+        const auto window = haystack.substr(pos, hash_.window_size());
+        for (; it != entries_.end() && it->hash == hash; ++it) {
+            if (window == (*this)[it->id] && !f(pos, it->id)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    /**
+     * @brief Prepare the search for a range of patterns
+     * @param first, last A non-empty range of patterns convertible to `string_view`, pattern `i` gets id `i`.
+     *
+     * @note Throws `std::invalid_argument` if the range is empty or the patterns are empty or
+     * differ in size.
+     */
+    template<class Iter>
+    rabin_karp_searcher(Iter first, Iter last): hash_(first == last ? 0 : string_view(*first).size()) {
+        if (first == last) {
+            throw std::invalid_argument("rabin_karp_searcher needs at least one pattern");
+        }
+        if (hash_.window_size() == 0) {
+            throw std::invalid_argument("All patterns must have the same, non-zero, size");
+        }
+        for (; first != last; ++first) {
+            add(string_view(*first));
+        }
+        build();
+    }
+
+    rabin_karp_searcher(std::initializer_list<string_view> patterns): rabin_karp_searcher(patterns.begin(), patterns.end()) {}
+
+    /**
+     * @brief Get the number of patterns
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return patterns_.size() / hash_.window_size();
+    }
+
+    /**
+     * @brief Get the size shared by all patterns
+     */
+    [[nodiscard]] size_type pattern_size() const noexcept {
+        return hash_.window_size();
+    }
+
+    /**
+     * @brief Get the pattern with id `id`
+     */
+    [[nodiscard]] string_view operator[](size_type id) const noexcept {
+        return string_view(patterns_.data() + id * pattern_size(), pattern_size());
+    }
+
+    /**
+     * @brief Call `f` for every occurrence of every pattern
+     * @param haystack The view to search
+     * @param f Called as `f(pos, id)` with the start of each occurrence and the id of the pattern,
+     * in increasing position. Return `false` to stop the search.
+     */
+    template<class F>
+    void for_each_match(string_view haystack, F&& f) const {
+        const auto w = pattern_size();
+        if (haystack.size() < w) {
+            return;
+        }
+        auto rolling = hash_;
+        rolling.reset(haystack);
+        const auto last = haystack.size() - w;
+        for (size_type pos = 0;; ++pos) {
+            if (!check_window(haystack, pos, rolling.value(), f)) {
+                return;
+            }
+            if (pos == last) {
+                return;
+            }
+            rolling.roll(haystack[pos], haystack[pos + w]);
+        }
+    }
+
+    /**
+     * @brief Find the first occurrence of any pattern
+     * @return The position and the pattern id of the occurrence, or `npos` for both if not found.
+     * Of several patterns equal to the first occurrence the lowest id is returned.
+     */
+    [[nodiscard]] std::pair<size_type, size_type> find(string_view haystack) const {
+        std::pair<size_type, size_type> retval{npos, npos};
+        for_each_match(haystack, [&](size_type pos, size_type id) {
+            retval = {pos, id};
+            return false;
+        });
+        return retval;
+    }
+
+    /**
+     * @brief Check if the haystack contains any pattern
+     */
+    [[nodiscard]] bool contains(string_view haystack) const {
+        return find(haystack).first != npos;
+    }
+};
+}// namespace andwass
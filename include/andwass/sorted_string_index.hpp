@@ -0,0 +1,172 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+#include <andwass/detail/bits.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace andwass {
+/**
+ * @brief A static, sorted set of strings optimized for `lower_bound`
+ *
+ * The keys are stored in Eytzinger (breadth-first) order, so the first levels of every
+ * search share a few hot cache lines and the nodes a search may visit a couple of levels
+ * ahead are adjacent and can be prefetched. Each node caches the first 8 bytes of its key
+ * as a big-endian integer, so most steps are a single integer compare and the key bytes
+ * are only read when two prefixes are equal.
+ *
+ * Keys are copied into the index, ordered as `std::memcmp` orders them, and duplicates are removed.
+ */
+class sorted_string_index {
+public:
+    using size_type = std::size_t;
+
+private:
+    struct node {
+        std::uint64_t prefix;
+        size_type rank;
+    };
+
+    // Nodes 4k to 4k + 3, the grandchildren of node k, fill line k.
+    struct alignas(64) node_line {
+        node nodes[4];
+    };
+    static_assert(sizeof(node_line) == 64, "4 nodes must fill a cache line");
+
+    // A vector rather than a string, moving it never relocates the bytes the views point to.
+    std::vector<char> storage_;
+    std::vector<string_view> keys_;
+    // 1-based, node k has children 2k and 2k + 1.
+    std::vector<node_line> lines_;
+
+    [[nodiscard]] node& node_at(size_type k) noexcept {
+        return lines_[k / 4].nodes[k % 4];
+    }
+
+    [[nodiscard]] const node& node_at(size_type k) const noexcept {
+        return lines_[k / 4].nodes[k % 4];
+    }
+
+    static std::uint64_t prefix_of(string_view key) noexcept {
+        std::uint64_t prefix = 0;
+        const auto n = (std::min)(key.size(), size_type(8));
+        for (size_type i = 0; i < n; i++) {
+            prefix |= std::uint64_t(static_cast<unsigned char>(key[i])) << (56 - 8 * i);
+        }
+        return prefix;
+    }
+
+    size_type fill(size_type k, size_type rank) noexcept {
+        if (k <= keys_.size()) {
+            rank = fill(2 * k, rank);
+            node_at(k) = node{prefix_of(keys_[rank]), rank};
+            rank = fill(2 * k + 1, rank + 1);
+        }
+        return rank;
+    }
+
+    template<class Iter>
+    void build(Iter first, Iter last) {
+        std::vector<string_view> input;
+        size_type total = 0;
+        for (; first != last; ++first) {
+            input.emplace_back(*first);
+            total += input.back().size();
+        }
+        std::sort(input.begin(), input.end(), [](string_view lhs, string_view rhs) {
+            return detail::compare_bytes(lhs, rhs) < 0;
+        });
+        input.erase(std::unique(input.begin(), input.end()), input.end());
+
+        storage_.reserve(total);
+        for (auto key: input) {
+            storage_.insert(storage_.end(), key.begin(), key.end());
+        }
+        size_type offset = 0;
+        for (auto key: input) {
+            keys_.emplace_back(storage_.data() + offset, key.size());
+            offset += key.size();
+        }
+        lines_.resize(keys_.size() / 4 + 1);
+        fill(1, 0);
+    }
+
+public:
+    sorted_string_index() = default;
+
+    /**
+     * @brief Build the index from a range of keys
+     * @param first, last A range of keys convertible to `string_view`
+     */
+    template<class Iter>
+    sorted_string_index(Iter first, Iter last) {
+        build(first, last);
+    }
+
+    sorted_string_index(std::initializer_list<string_view> keys) {
+        build(keys.begin(), keys.end());
+    }
+
+    // The views in `keys_` point into `storage_`.
+    sorted_string_index(const sorted_string_index&) = delete;
+    sorted_string_index& operator=(const sorted_string_index&) = delete;
+    sorted_string_index(sorted_string_index&&) noexcept = default;
+    sorted_string_index& operator=(sorted_string_index&&) noexcept = default;
+
+    /**
+     * @brief Get the number of distinct keys
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return keys_.size();
+    }
+
+    /**
+     * @brief Get a key by its rank in sorted order
+     * @note The behaviour is undefined if `rank >= size()`
+     */
+    [[nodiscard]] string_view operator[](size_type rank) const noexcept {
+        return keys_[rank];
+    }
+
+    /**
+     * @brief Find the first key that is not less than `key`
+     * @param key The key to search for
+     * @return The rank of the first key not less than `key`, or `size()` if there is none.
+     */
+    [[nodiscard]] size_type lower_bound(string_view key) const noexcept {
+        const auto key_prefix = prefix_of(key);
+        const auto n = keys_.size();
+        size_type k = 1;
+        while (k <= n) {
+            // The 4 grandchildren of k share a cache line, 2 levels ahead.
+            if (4 * k <= n) {
+                detail::prefetch(&lines_[k]);
+            }
+            const auto& current = node_at(k);
+            const bool less = current.prefix != key_prefix
+                ? current.prefix < key_prefix
+                : detail::compare_bytes(keys_[current.rank], key) < 0;
+            k = 2 * k + (less ? 1 : 0);
+        }
+        // Undo the trailing right turns, and the final left turn, to find the answer.
+        k >>= detail::countr_zero(~std::uint64_t(k)) + 1;
+        return k == 0 ? n : node_at(k).rank;
+    }
+
+    /**
+     * @brief Check if a key is in the index
+     */
+    [[nodiscard]] bool contains(string_view key) const noexcept {
+        const auto rank = lower_bound(key);
+        return rank < keys_.size() && keys_[rank] == key;
+    }
+};
+}// namespace andwass
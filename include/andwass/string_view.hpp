@@ -5,10 +5,13 @@
 
 
 #pragma once
+#include <cstdint>
 #include <cstring>
 #include <cctype>
 #include <cmath>
 #include <algorithm>
+#include <functional>
+#include <iterator>
 #include <stdexcept>
 
 namespace andwass {
@@ -26,7 +29,80 @@ inline constexpr int compare(const char* left, const char* right, size_t n)
     }
     return 0;
 }
+
+/**
+ * @brief Load up to 8 chars as a little-endian word, zero padded.
+ */
+inline constexpr std::uint64_t load_word(const char* data, std::size_t size) noexcept {
+    std::uint64_t word = 0;
+    for(std::size_t i=0; i<size; i++) {
+        word |= std::uint64_t(static_cast<unsigned char>(data[i])) << (8*i);
+    }
+    return word;
 }
+
+inline constexpr std::uint64_t rotl(std::uint64_t x, int r) noexcept {
+    return (x << r) | (x >> (64 - r));
+}
+
+/**
+ * @brief Final avalanche step, every input bit affects every output bit.
+ */
+inline constexpr std::uint64_t hash_mix(std::uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * @brief Hash `[data, data + size)` 8 bytes at a time.
+ * @param transform Applied to every loaded word before it is mixed in, zero bytes
+ * used as padding must map to zero.
+ */
+template<class WordTransform>
+constexpr std::uint64_t hash_bytes(const char* data, std::size_t size, WordTransform transform) noexcept {
+    std::uint64_t h = 0x9e3779b97f4a7c15ull ^ size;
+    std::size_t i = 0;
+    for(; size - i >= 8; i += 8) {
+        h = rotl(h ^ (transform(load_word(data + i, 8)) * 0x87c37b91114253d5ull), 31) * 0x4cf5ad432745937full;
+    }
+    if (i < size) {
+        h = rotl(h ^ (transform(load_word(data + i, size - i)) * 0x87c37b91114253d5ull), 31) * 0x4cf5ad432745937full;
+    }
+    return hash_mix(h);
+}
+
+/**
+ * Number of chars handled per step by the block-wise scanning helpers.
+ */
+inline constexpr std::size_t block_size = 64;
+
+/**
+ * @brief Count the occurrences of `ch` in `[data, data + size)`
+ *
+ * The loop is free of branches and early exits so that compilers can vectorize it,
+ * keeping per-lane partial sums and only reducing them once at the end.
+ */
+inline constexpr std::size_t count(const char* data, std::size_t size, char ch) noexcept {
+    std::size_t count = 0;
+    for(std::size_t i=0; i<size; i++) {
+        count += data[i] == ch ? 1 : 0;
+    }
+    return count;
+}
+
+/**
+ * @brief Count the occurrences of `ch` in `[data, data + block_size)`
+ */
+inline constexpr std::size_t count_block(const char* data, char ch) noexcept {
+    return count(data, block_size, ch);
+}
+}
+class reverse_match_range;
+
 class string_view {
     const char *data_ = nullptr;
     std::size_t size_ = 0;
@@ -282,27 +358,61 @@ public:
         return npos;
     }
 
+    /**
+     * @brief Find the nth occurrence of a specified character
+     * @param ch The character to search for.
+     * @param n Which occurrence to find, 0-based
+     * @return The index of the nth (0-based) occurrence of `ch`, or `npos` if not found.
+     *
+     * The view is scanned once. Whole blocks that contain too few matches are skipped
+     * using a branch-free count.
+     */
+    [[nodiscard]] constexpr size_type find_nth(char ch, size_type n) const noexcept {
+        size_type i = 0;
+        for(; size() - i >= detail::block_size; i += detail::block_size) {
+            const auto in_block = detail::count_block(data_ + i, ch);
+            if (in_block > n) {
+                break;
+            }
+            n -= in_block;
+        }
+        for(; i<size(); i++) {
+            if (data_[i] == ch) {
+                if (n == 0) {
+                    return i;
+                }
+                --n;
+            }
+        }
+        return npos;
+    }
+
     /**
      * @brief Find then nth occurrence of a specified needle
      * @param needle The needle to search for.
      * @param n Which occurrence to find, 0-based
      * @return The start of the nth (0-based) occurrence of the needle.
      *
-     * `sv.find_nth(needle, 0)` is equivalent to `sv.find(needle)`.
+     * `sv.find_nth(needle, 0)` is equivalent to `sv.find(needle)`. Occurrences may overlap.
+     * The view is scanned once, regardless of `n`.
      */
     [[nodiscard]] constexpr size_type find_nth(string_view needle, size_type n) const noexcept {
-        string_view haystack = *this;
-        for(size_type i=0; i<=n && haystack.size() >= needle.size(); i++) {
-            auto found = haystack.find(needle);
-            if (found == npos) {
-                return npos;
-            }
-            else if (i == n) {
-                return haystack.data() - data() + found;
-            }
-            else {
-                // +1 since we need to step over the start of the found index.
-                haystack.remove_prefix(found + 1);
+        if (needle.is_empty()) {
+            return n <= size() ? n : npos;
+        }
+        else if (needle.size() == 1) {
+            return find_nth(needle.front(), n);
+        }
+        else if (size() >= needle.size()) {
+            const auto first = needle.front();
+            const auto search_size = size() - needle.size() + 1;
+            for (size_type i=0; i < search_size; ++i) {
+                if (data_[i] == first && substr(i).starts_with(needle)) {
+                    if (n == 0) {
+                        return i;
+                    }
+                    --n;
+                }
             }
         }
         return npos;
@@ -347,6 +457,111 @@ public:
         return npos;
     }
 
+    /**
+     * @brief Find the nth occurrence of a character, counting from the end
+     * @param ch The character to search for.
+     * @param n Which occurrence to find, 0-based, where 0 is the last occurrence.
+     * @return The index of the nth-from-last occurrence of `ch`, or `npos` if not found.
+     *
+     * The view is scanned backwards once, skipping whole blocks with too few matches.
+     */
+    [[nodiscard]] constexpr size_type rfind_nth(char ch, size_type n) const noexcept {
+        size_type i = size();
+        for(; i >= detail::block_size; i -= detail::block_size) {
+            const auto in_block = detail::count_block(data_ + i - detail::block_size, ch);
+            if (in_block > n) {
+                break;
+            }
+            n -= in_block;
+        }
+        for(; i > 0; --i) {
+            if (data_[i-1] == ch) {
+                if (n == 0) {
+                    return i-1;
+                }
+                --n;
+            }
+        }
+        return npos;
+    }
+
+    /**
+     * @brief Find the nth occurrence of a needle, counting from the end
+     * @param needle The needle to search for.
+     * @param n Which occurrence to find, 0-based, where 0 is the last occurrence.
+     * @return The start of the nth-from-last occurrence of the needle, or `npos` if not found.
+     *
+     * `sv.rfind_nth(needle, 0)` is equivalent to `sv.rfind(needle)`. Occurrences may overlap.
+     * Only the tail of the view up to the found occurrence is scanned.
+     */
+    [[nodiscard]] constexpr size_type rfind_nth(string_view needle, size_type n) const noexcept {
+        if (needle.is_empty()) {
+            return n <= size() ? size() - n : npos;
+        }
+        else if (needle.size() == 1) {
+            return rfind_nth(needle.front(), n);
+        }
+        else if (size() >= needle.size()) {
+            const auto first = needle.front();
+            for (size_type i=size() - needle.size() + 1; i > 0; --i) {
+                if (data_[i-1] == first && substr(i-1).starts_with(needle)) {
+                    if (n == 0) {
+                        return i-1;
+                    }
+                    --n;
+                }
+            }
+        }
+        return npos;
+    }
+
+    /**
+     * @brief Lazily iterate over all occurrences of a needle, last occurrence first
+     * @param needle The needle to search for.
+     * @return A range of the start indices of all (possibly overlapping) occurrences, in descending order.
+     *
+     * Each increment only searches backwards from the previous occurrence, so
+     * stopping early never touches the head of the view.
+     */
+    [[nodiscard]] constexpr reverse_match_range rmatches(string_view needle) const noexcept;
+
+    /**
+     * @brief Count the occurrences of a character
+     * @param ch The character to count
+     * @return The number of times `ch` occurs in the view.
+     */
+    [[nodiscard]] constexpr size_type count(char ch) const noexcept {
+        return detail::count(data_, size_, ch);
+    }
+
+    /**
+     * @brief Count the non-overlapping occurrences of a needle
+     * @param needle The needle to count
+     * @return The number of non-overlapping occurrences of `needle`, scanning from the start.
+     *
+     * An empty needle is found at every index, including `size()`, so `size() + 1` is returned.
+     */
+    [[nodiscard]] constexpr size_type count(string_view needle) const noexcept {
+        if (needle.size() == 1) {
+            return count(needle.front());
+        }
+        return count_impl(needle, needle.size());
+    }
+
+    /**
+     * @brief Count all occurrences of a needle, including overlapping ones
+     * @param needle The needle to count
+     * @return The number of indices where `needle` starts.
+     *
+     * `"aaaa"_sv.count_overlapping("aa")` is 3 while `"aaaa"_sv.count("aa")` is 2.
+     */
+    [[nodiscard]] constexpr size_type count_overlapping(string_view needle) const noexcept {
+        if (needle.size() == 1) {
+            return count(needle.front());
+        }
+        return count_impl(needle, 1);
+    }
+
     /**
      * @brief Check if a sub string contains a certain needle
      * @param needle The needle to search
@@ -396,8 +611,130 @@ public:
     friend constexpr bool operator!=(const string_view& lhs, const string_view& rhs) noexcept {
         return !(lhs == rhs);
     }
+
+private:
+    constexpr size_type count_impl(string_view needle, size_type step) const noexcept {
+        if (needle.is_empty()) {
+            return size() + 1;
+        }
+        else if (size() < needle.size()) {
+            return 0;
+        }
+        size_type retval = 0;
+        const auto first = needle.front();
+        const auto search_size = size() - needle.size() + 1;
+        for (size_type i=0; i < search_size;) {
+            if (data_[i] == first && substr(i).starts_with(needle)) {
+                ++retval;
+                i += step;
+            }
+            else {
+                ++i;
+            }
+        }
+        return retval;
+    }
 };
 
+/**
+ * @brief A lazy range of needle occurrences, visited from the end of the haystack.
+ *
+ * Created by `string_view::rmatches`. Dereferencing an iterator yields the start index
+ * of an occurrence.
+ */
+class reverse_match_range {
+    string_view haystack_;
+    string_view needle_;
+public:
+    class iterator {
+        string_view haystack_;
+        string_view needle_;
+        string_view::size_type pos_ = string_view::npos;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = string_view::size_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = value_type;
+
+        constexpr iterator() noexcept = default;
+        constexpr iterator(string_view haystack, string_view needle, string_view::size_type pos) noexcept: haystack_(haystack), needle_(needle), pos_(pos) {}
+
+        [[nodiscard]] constexpr value_type operator*() const noexcept {
+            return pos_;
+        }
+
+        constexpr iterator& operator++() noexcept {
+            if (pos_ == 0) {
+                pos_ = string_view::npos;
+            }
+            else {
+                // Any earlier occurrence must end before the end of the current one.
+                pos_ = haystack_.substr(0, pos_ + needle_.size() - 1).rfind(needle_);
+            }
+            return *this;
+        }
+
+        constexpr iterator operator++(int) noexcept {
+            auto retval = *this;
+            ++*this;
+            return retval;
+        }
+
+        friend constexpr bool operator==(const iterator& lhs, const iterator& rhs) noexcept {
+            return lhs.pos_ == rhs.pos_;
+        }
+
+        friend constexpr bool operator!=(const iterator& lhs, const iterator& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+    };
+
+    constexpr reverse_match_range(string_view haystack, string_view needle) noexcept: haystack_(haystack), needle_(needle) {}
+
+    [[nodiscard]] constexpr iterator begin() const noexcept {
+        return iterator(haystack_, needle_, haystack_.rfind(needle_));
+    }
+
+    [[nodiscard]] constexpr iterator end() const noexcept {
+        return iterator();
+    }
+};
+
+constexpr reverse_match_range string_view::rmatches(string_view needle) const noexcept {
+    return reverse_match_range(*this, needle);
+}
+
+/**
+ * @brief Hash the contents of a view
+ * @param sv The view to hash
+ * @return A 64-bit hash of the chars in `sv`, suitable for hash tables and sketches.
+ *
+ * The hash is stable across platforms and only depends on the contents of the view.
+ */
+[[nodiscard]] constexpr std::uint64_t hash(string_view sv) noexcept {
+    return detail::hash_bytes(sv.data(), sv.size(), [](std::uint64_t word) {
+        return word;
+    });
+}
+
+namespace detail
+{
+/**
+ * @brief Compare two views as sequences of unsigned bytes, like `std::memcmp`.
+ *
+ * Unlike `string_view::compare`, which compares `char`, the result does not depend on the signedness of `char`.
+ */
+inline int compare_bytes(string_view lhs, string_view rhs) noexcept {
+    const auto n = (std::min)(lhs.size(), rhs.size());
+    const int result = n == 0 ? 0 : std::memcmp(lhs.data(), rhs.data(), n);
+    if (result != 0) {
+        return result;
+    }
+    return lhs.size() < rhs.size() ? -1 : (lhs.size() > rhs.size() ? 1 : 0);
+}
+}
+
 namespace literals {
 constexpr string_view operator""_sv(const char *s, std::size_t len) noexcept {
     return string_view(s, len);
@@ -406,4 +743,13 @@ constexpr string_view operator""_sv(const char *s, std::size_t len) noexcept {
 
 using literals::operator""_sv;
 
-}// namespace andwass
\ No newline at end of file
+}// namespace andwass
+
+namespace std {
+template<>
+struct hash<andwass::string_view> {
+    [[nodiscard]] std::size_t operator()(andwass::string_view sv) const noexcept {
+        return static_cast<std::size_t>(andwass::hash(sv));
+    }
+};
+}// namespace std
@@ -0,0 +1,376 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+#include <andwass/detail/parallel.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace andwass {
+namespace detail
+{
+/**
+ * @brief Sort the suffixes of `s[0, n)` with SA-IS into `sa[0, n)`
+ * @param s The symbols, each in `[0, upper]`.
+ * @param sa Output, the start positions of the suffixes in lexicographic order.
+ *
+ * Suffixes are classified as S (smaller than the next suffix) or L, the leftmost S of every
+ * run (LMS) are sorted by induced sorting, and if LMS substrings are not all unique they are
+ * renamed and sorted recursively. Runs in O(n) time.
+ *
+ * Besides `sa` only a bit per symbol and one bucket array of `upper + 1` entries are
+ * allocated per level: there are at most `n / 2` LMS positions, so their names and the
+ * reduced string are kept in the upper half of `sa` and the recursion sorts into the lower
+ * half. The bucket array is released before recursing.
+ */
+template<class T>
+void sa_is(const T* s, std::size_t n, std::size_t upper, std::size_t* sa) {
+    constexpr auto none = static_cast<std::size_t>(-1);
+    if (n <= 2) {
+        if (n == 1) {
+            sa[0] = 0;
+        }
+        else if (n == 2) {
+            sa[0] = s[0] < s[1] ? 0 : 1;
+            sa[1] = 1 - sa[0];
+        }
+        return;
+    }
+
+    // The virtual sentinel after the text makes the last suffix L.
+    std::vector<bool> is_s(n);
+    for (auto i = n - 1; i-- > 0;) {
+        is_s[i] = s[i] == s[i + 1] ? is_s[i + 1] : s[i] < s[i + 1];
+    }
+    auto is_lms = [&](std::size_t i) {
+        return i > 0 && i < n && is_s[i] && !is_s[i - 1];
+    };
+
+    std::vector<std::size_t> bucket;
+    // Set bucket[c] to where the bucket of `c` starts, or ends if `ends`.
+    auto fill_buckets = [&](bool ends) {
+        bucket.assign(upper + 1, 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            ++bucket[s[i]];
+        }
+        std::size_t sum = 0;
+        for (auto& b: bucket) {
+            sum += b;
+            b = ends ? sum : sum - b;
+        }
+    };
+    auto induce = [&]() {
+        fill_buckets(false);
+        sa[bucket[s[n - 1]]++] = n - 1;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto v = sa[i];
+            if (v != none && v >= 1 && !is_s[v - 1]) {
+                sa[bucket[s[v - 1]]++] = v - 1;
+            }
+        }
+        fill_buckets(true);
+        for (auto i = n; i-- > 0;) {
+            const auto v = sa[i];
+            if (v != none && v >= 1 && is_s[v - 1]) {
+                sa[--bucket[s[v - 1]]] = v - 1;
+            }
+        }
+    };
+
+    // Sort LMS substrings by inducing from the LMS positions in arbitrary order.
+    std::fill_n(sa, n, none);
+    fill_buckets(true);
+    std::size_t m = 0;
+    for (std::size_t i = 1; i < n; ++i) {
+        if (is_lms(i)) {
+            sa[--bucket[s[i]]] = i;
+            ++m;
+        }
+    }
+    induce();
+    if (m == 0) {
+        // All suffixes are L and were induced from the last one.
+        return;
+    }
+
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (is_lms(sa[i])) {
+            sa[j++] = sa[i];
+        }
+    }
+    // Name LMS substrings so that equal substrings share a name, LMS positions are at least
+    // 2 apart so the name of position `p` fits at `sa[m + p / 2]`.
+    std::fill(sa + m, sa + n, none);
+    std::size_t name = 0;
+    for (std::size_t i = 0; i < m; ++i) {
+        const auto p = sa[i];
+        if (i > 0) {
+            const auto q = sa[i - 1];
+            for (std::size_t d = 0;; ++d) {
+                // Reaching the end of the text means hitting the unique virtual sentinel.
+                if (p + d == n || q + d == n || s[p + d] != s[q + d] || is_s[p + d] != is_s[q + d]) {
+                    ++name;
+                    break;
+                }
+                if (d > 0 && is_lms(p + d)) {
+                    break;
+                }
+            }
+        }
+        sa[m + p / 2] = name;
+    }
+    j = n;
+    for (auto i = n; i-- > m;) {
+        if (sa[i] != none) {
+            sa[--j] = sa[i];
+        }
+    }
+
+    // Sort the reduced string, kept in `sa[n - m, n)`, into `sa[0, m)`.
+    auto* reduced = sa + n - m;
+    if (name + 1 < m) {
+        bucket = {};
+        sa_is(static_cast<const std::size_t*>(reduced), m, name, sa);
+    }
+    else {
+        for (std::size_t i = 0; i < m; ++i) {
+            sa[reduced[i]] = i;
+        }
+    }
+    j = 0;
+    for (std::size_t i = 1; i < n; ++i) {
+        if (is_lms(i)) {
+            reduced[j++] = i;
+        }
+    }
+    for (std::size_t i = 0; i < m; ++i) {
+        sa[i] = reduced[sa[i]];
+    }
+    std::fill(sa + m, sa + n, none);
+
+    // Place the sorted LMS positions at the ends of their buckets, last first, and induce.
+    fill_buckets(true);
+    for (auto i = m; i-- > 0;) {
+        const auto p = sa[i];
+        sa[i] = none;
+        sa[--bucket[s[p]]] = p;
+    }
+    induce();
+}
+
+/**
+ * @brief Sort the suffixes of `s[0, n)` with SA-IS
+ * @return The start positions of the suffixes in lexicographic order.
+ */
+template<class T>
+std::vector<std::size_t> sa_is(const T* s, std::size_t n, std::size_t upper) {
+    std::vector<std::size_t> sa(n);
+    sa_is(s, n, upper, sa.data());
+    return sa;
+}
+}// namespace detail
+
+/**
+ * @brief The sorted suffixes of a text, for fast substring search
+ *
+ * Suffix start positions are sorted with the linear time SA-IS algorithm, in `std::memcmp`
+ * order (bytes compare as `unsigned char`). Sorting needs the `sizeof(size_type)` bytes per
+ * text byte of the result, plus about 1/8 byte per byte of type bits and, when LMS
+ * substrings are mostly distinct, a bucket array of up to half the result.
+ * Occurrences of a needle of length `m` form a contiguous range of suffixes that is found
+ * by binary search in O(m log n).
+ *
+ * Optionally the LCP array is built with Kasai's algorithm: `lcp(i)` is the length of the
+ * longest common prefix of the suffixes of rank `i - 1` and `i`.
+ *
+ * @note The text is not copied and must outlive the suffix array.
+ */
+class suffix_array {
+public:
+    using size_type = std::size_t;
+
+    static constexpr size_type npos = string_view::npos;
+
+private:
+    string_view text_;
+    std::vector<size_type> sa_;
+    std::vector<size_type> lcp_;
+    bool has_lcp_ = false;
+
+    /**
+     * @brief Compare the suffix of rank `rank`, truncated to the size of `needle`, with `needle`
+     */
+    [[nodiscard]] int compare_prefix(size_type rank, string_view needle) const noexcept {
+        return detail::compare_bytes(text_.substr(sa_[rank], needle.size()), needle);
+    }
+
+    /**
+     * @brief Build the LCP array with Kasai's algorithm, in chunks of text positions
+     *
+     * The permuted LCP only decreases by at most one between neighbouring text positions,
+     * which Kasai uses to carry the match length forward. A chunk starting without that
+     * carry is still correct, so chunks are processed in parallel at the cost of some
+     * repeated comparisons at chunk starts.
+     */
+    void build_lcp(unsigned num_threads) {
+        const auto n = sa_.size();
+        // phi[p] is the suffix preceding suffix `p` in sorted order, reused for the permuted LCP.
+        std::vector<size_type> phi(n);
+        lcp_.resize(n);
+        if (n == 0) {
+            return;
+        }
+        phi[sa_[0]] = npos;
+        for (size_type i = 1; i < n; ++i) {
+            phi[sa_[i]] = sa_[i - 1];
+        }
+        const auto chunk = (n + num_threads - 1) / num_threads;
+        const auto* text = text_.data();
+        detail::run_parallel(num_threads, [&](unsigned t) {
+            const auto first = (std::min)(n, t * chunk);
+            const auto last = (std::min)(n, first + chunk);
+            size_type h = 0;
+            for (auto p = first; p < last; ++p) {
+                const auto q = phi[p];
+                if (q == npos) {
+                    phi[p] = 0;
+                    h = 0;
+                    continue;
+                }
+                while (p + h < n && q + h < n && text[p + h] == text[q + h]) {
+                    ++h;
+                }
+                phi[p] = h;
+                h = h > 0 ? h - 1 : 0;
+            }
+        });
+        for (size_type i = 0; i < n; ++i) {
+            lcp_[i] = phi[sa_[i]];
+        }
+    }
+
+public:
+    /**
+     * @brief Sort the suffixes of `text`
+     * @param text The text to index, it is not copied.
+     * @param with_lcp Also build the LCP array.
+     * @param num_threads Threads used to build the LCP array, 0 to use one per hardware thread.
+     * Sorting the suffixes is always sequential.
+     */
+    explicit suffix_array(string_view text, bool with_lcp = false, unsigned num_threads = 1)
+        : text_(text), sa_(detail::sa_is(reinterpret_cast<const unsigned char*>(text.data()), text.size(), 255)) {
+        if (with_lcp) {
+            if (num_threads == 0) {
+                num_threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+            }
+            // Chunks shorter than this are not worth a thread.
+            constexpr size_type min_chunk = size_type(1) << 16;
+            num_threads = static_cast<unsigned>((std::min)(size_type(num_threads), (std::max)(sa_.size() / min_chunk, size_type(1))));
+            build_lcp(num_threads);
+            has_lcp_ = true;
+        }
+    }
+
+    [[nodiscard]] string_view text() const noexcept {
+        return text_;
+    }
+
+    /**
+     * @brief Get the number of suffixes, equal to the size of the text
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return sa_.size();
+    }
+
+    /**
+     * @brief Get the start position of the suffix with rank `rank`
+     */
+    [[nodiscard]] size_type operator[](size_type rank) const noexcept {
+        return sa_[rank];
+    }
+
+    /**
+     * @brief Get all suffix start positions in sorted order
+     */
+    [[nodiscard]] const std::vector<size_type>& positions() const noexcept {
+        return sa_;
+    }
+
+    [[nodiscard]] bool has_lcp() const noexcept {
+        return has_lcp_;
+    }
+
+    /**
+     * @brief Get the longest common prefix length of the suffixes of rank `rank - 1` and `rank`, 0 for rank 0
+     *
+     * Throws `std::out_of_range` if the LCP array was not built or `rank` is out of range.
+     */
+    [[nodiscard]] size_type lcp(size_type rank) const {
+        return lcp_.at(rank);
+    }
+
+    /**
+     * @brief Find the ranks of the suffixes starting with `needle`
+     * @return The half-open range `[first, last)` of ranks, empty if `needle` does not occur.
+     *
+     * An empty needle matches every suffix.
+     */
+    [[nodiscard]] std::pair<size_type, size_type> equal_range(string_view needle) const noexcept {
+        size_type lo = 0;
+        size_type hi = sa_.size();
+        while (lo < hi) {
+            const auto mid = lo + (hi - lo) / 2;
+            if (compare_prefix(mid, needle) < 0) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        const auto first = lo;
+        hi = sa_.size();
+        while (lo < hi) {
+            const auto mid = lo + (hi - lo) / 2;
+            if (compare_prefix(mid, needle) <= 0) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        return {first, lo};
+    }
+
+    /**
+     * @brief Count the, possibly overlapping, occurrences of `needle`
+     */
+    [[nodiscard]] size_type count(string_view needle) const noexcept {
+        const auto range = equal_range(needle);
+        return range.second - range.first;
+    }
+
+    [[nodiscard]] bool contains(string_view needle) const noexcept {
+        return count(needle) != 0;
+    }
+
+    /**
+     * @brief Find the positions of all, possibly overlapping, occurrences of `needle`
+     * @return The positions in ascending order.
+     */
+    [[nodiscard]] std::vector<size_type> find_all(string_view needle) const {
+        const auto range = equal_range(needle);
+        std::vector<size_type> retval(sa_.begin() + static_cast<std::ptrdiff_t>(range.first), sa_.begin() + static_cast<std::ptrdiff_t>(range.second));
+        std::sort(retval.begin(), retval.end());
+        return retval;
+    }
+};
+}// namespace andwass
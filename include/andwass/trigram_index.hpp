@@ -0,0 +1,310 @@
+//          Copyright Andreas Wass 2022
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+
+#pragma once
+#include <andwass/string_view.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace andwass {
+/**
+ * @brief An inverted index from trigrams to documents, for substring search over many documents
+ *
+ * Every distinct 3 byte substring (trigram) of a document adds the document to the posting
+ * list of that trigram. A needle of at least 3 chars can only occur in documents listed for
+ * all of its trigrams, so the posting lists are intersected, smallest first, and only the
+ * remaining candidates are searched with `string_view::find`.
+ *
+ * Posting lists are split into blocks of 128 document ids. A block stores its first id
+ * directly and the rest as varint encoded deltas, and the block start ids are kept apart
+ * so intersections skip whole blocks without decoding them.
+ *
+ * @note The documents are not copied and must outlive the index.
+ */
+class trigram_index {
+public:
+    using size_type = std::size_t;
+    using doc_id = std::uint32_t;
+
+private:
+    static constexpr size_type block_size = 128;
+
+    struct posting_list {
+        std::uint32_t trigram;
+        std::uint32_t count;
+        size_type first_block;
+    };
+
+    struct block {
+        doc_id first;
+        size_type offset;
+    };
+
+    std::vector<string_view> docs_;
+    std::vector<posting_list> lists_;
+    std::vector<block> blocks_;
+    std::vector<unsigned char> bytes_;
+
+    [[nodiscard]] static std::uint32_t trigram_at(string_view str, size_type i) noexcept {
+        return (std::uint32_t(static_cast<unsigned char>(str[i])) << 16)
+            | (std::uint32_t(static_cast<unsigned char>(str[i + 1])) << 8)
+            | std::uint32_t(static_cast<unsigned char>(str[i + 2]));
+    }
+
+    /**
+     * @brief Append the distinct trigrams of `str` to `out`, sorted
+     */
+    static void trigrams(string_view str, std::vector<std::uint32_t>& out) {
+        out.clear();
+        for (size_type i = 0; i + 3 <= str.size(); ++i) {
+            out.push_back(trigram_at(str, i));
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+    void put_varint(std::uint32_t value) {
+        while (value >= 0x80) {
+            bytes_.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        bytes_.push_back(static_cast<unsigned char>(value));
+    }
+
+    /**
+     * @brief Sequential reader of one posting list that can skip ahead
+     */
+    class cursor {
+        const trigram_index& index_;
+        const posting_list& list_;
+        size_type block_;
+        size_type end_block_;
+        doc_id docs_[block_size];
+        size_type size_ = 0;
+        size_type pos_ = 0;
+
+        void load(size_type b) noexcept {
+            block_ = b;
+            const auto first_in_list = (b - list_.first_block) * block_size;
+            size_ = (std::min)(block_size, size_type(list_.count) - first_in_list);
+            pos_ = 0;
+            auto doc = index_.blocks_[b].first;
+            const auto* p = index_.bytes_.data() + index_.blocks_[b].offset;
+            docs_[0] = doc;
+            for (size_type i = 1; i < size_; ++i) {
+                std::uint32_t delta = 0;
+                for (unsigned shift = 0;; shift += 7) {
+                    const auto byte = *p++;
+                    delta |= std::uint32_t(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0) {
+                        break;
+                    }
+                }
+                doc += delta;
+                docs_[i] = doc;
+            }
+        }
+
+    public:
+        cursor(const trigram_index& index, const posting_list& list) noexcept
+            : index_(index), list_(list), block_(list.first_block),
+              end_block_(list.first_block + (list.count + block_size - 1) / block_size) {
+            load(block_);
+        }
+
+        /**
+         * @brief Advance to the first id that is at least `target`
+         * @return false if the list has no such id.
+         */
+        bool seek(doc_id target) noexcept {
+            if (docs_[size_ - 1] < target) {
+                auto b = block_ + 1;
+                while (b + 1 < end_block_ && index_.blocks_[b + 1].first <= target) {
+                    ++b;
+                }
+                if (b == end_block_) {
+                    pos_ = size_;
+                    return false;
+                }
+                load(b);
+            }
+            pos_ = static_cast<size_type>(std::lower_bound(docs_ + pos_, docs_ + size_, target) - docs_);
+            if (pos_ == size_ && block_ + 1 < end_block_) {
+                // `target` falls between this block and the next, which starts above it.
+                load(block_ + 1);
+            }
+            return pos_ < size_;
+        }
+
+        [[nodiscard]] doc_id value() const noexcept {
+            return docs_[pos_];
+        }
+
+        void decode_all(std::vector<doc_id>& out) {
+            for (auto b = block_; b < end_block_; ++b) {
+                load(b);
+                out.insert(out.end(), docs_, docs_ + size_);
+            }
+        }
+    };
+
+    void build() {
+        if (docs_.size() > (std::numeric_limits<doc_id>::max)()) {
+            throw std::length_error("Too many documents for trigram_index");
+        }
+        // (trigram << 32 | doc), sorted to group documents by trigram in ascending order.
+        std::vector<std::uint64_t> pairs;
+        std::vector<std::uint32_t> doc_trigrams;
+        for (size_type d = 0; d < docs_.size(); ++d) {
+            trigrams(docs_[d], doc_trigrams);
+            for (auto t: doc_trigrams) {
+                pairs.push_back(std::uint64_t(t) << 32 | d);
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+
+        for (size_type i = 0; i < pairs.size();) {
+            const auto trigram = static_cast<std::uint32_t>(pairs[i] >> 32);
+            lists_.push_back(posting_list{trigram, 0, blocks_.size()});
+            auto& list = lists_.back();
+            doc_id prev = 0;
+            for (; i < pairs.size() && (pairs[i] >> 32) == trigram; ++i) {
+                const auto doc = static_cast<doc_id>(pairs[i]);
+                if (list.count % block_size == 0) {
+                    blocks_.push_back(block{doc, bytes_.size()});
+                }
+                else {
+                    put_varint(doc - prev);
+                }
+                prev = doc;
+                ++list.count;
+            }
+        }
+    }
+
+    [[nodiscard]] const posting_list* find_list(std::uint32_t trigram) const noexcept {
+        auto it = std::lower_bound(lists_.begin(), lists_.end(), trigram, [](const posting_list& list, std::uint32_t t) {
+            return list.trigram < t;
+        });
+        return it != lists_.end() && it->trigram == trigram ? &*it : nullptr;
+    }
+
+    /**
+     * @brief Ids of the documents that may contain `needle`, in ascending order
+     */
+    [[nodiscard]] std::vector<doc_id> candidates(string_view needle) const {
+        std::vector<doc_id> retval;
+        if (needle.size() < 3) {
+            retval.resize(docs_.size());
+            for (size_type d = 0; d < docs_.size(); ++d) {
+                retval[d] = static_cast<doc_id>(d);
+            }
+            return retval;
+        }
+        std::vector<std::uint32_t> needle_trigrams;
+        trigrams(needle, needle_trigrams);
+        std::vector<const posting_list*> lists;
+        for (auto t: needle_trigrams) {
+            const auto* list = find_list(t);
+            if (!list) {
+                return retval;
+            }
+            lists.push_back(list);
+        }
+        std::sort(lists.begin(), lists.end(), [](const posting_list* lhs, const posting_list* rhs) {
+            return lhs->count < rhs->count;
+        });
+        cursor(*this, *lists[0]).decode_all(retval);
+        for (size_type l = 1; l < lists.size() && !retval.empty(); ++l) {
+            cursor c(*this, *lists[l]);
+            size_type kept = 0;
+            for (auto doc: retval) {
+                if (!c.seek(doc)) {
+                    break;
+                }
+                if (c.value() == doc) {
+                    retval[kept++] = doc;
+                }
+            }
+            retval.resize(kept);
+        }
+        return retval;
+    }
+
+public:
+    /**
+     * @brief Index a range of documents
+     * @param first, last A range of documents convertible to `string_view`, document `i` gets id `i`.
+     *
+     * @note Throws `std::length_error` if there are `2^32` documents or more.
+     */
+    template<class Iter>
+    trigram_index(Iter first, Iter last) {
+        for (; first != last; ++first) {
+            docs_.emplace_back(*first);
+        }
+        build();
+    }
+
+    trigram_index(std::initializer_list<string_view> docs): docs_(docs) {
+        build();
+    }
+
+    /**
+     * @brief Get the number of documents
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return docs_.size();
+    }
+
+    /**
+     * @brief Get the document with id `id`
+     */
+    [[nodiscard]] string_view operator[](size_type id) const noexcept {
+        return docs_[id];
+    }
+
+    /**
+     * @brief Get the number of distinct trigrams in all documents
+     */
+    [[nodiscard]] size_type trigram_count() const noexcept {
+        return lists_.size();
+    }
+
+    /**
+     * @brief Find the documents containing `needle`
+     * @return The ids of the documents, in ascending order.
+     *
+     * Needles shorter than 3 chars have no trigrams and are searched for in every document.
+     */
+    [[nodiscard]] std::vector<size_type> find(string_view needle) const {
+        std::vector<size_type> retval;
+        for (auto doc: candidates(needle)) {
+            if (docs_[doc].find(needle) != string_view::npos) {
+                retval.push_back(doc);
+            }
+        }
+        return retval;
+    }
+
+    /**
+     * @brief Check if any document contains `needle`
+     */
+    [[nodiscard]] bool contains(string_view needle) const {
+        for (auto doc: candidates(needle)) {
+            if (docs_[doc].find(needle) != string_view::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+}// namespace andwass
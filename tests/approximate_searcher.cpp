@@ -0,0 +1,100 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/approximate_searcher.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+// Sellers' algorithm, all ends of substrings within `k` edits of `needle`.
+std::vector<size_t> reference_ends(const std::string& needle, const std::string& haystack, size_t k) {
+    std::vector<size_t> column(needle.size() + 1);
+    for (size_t i = 0; i <= needle.size(); i++) {
+        column[i] = i;
+    }
+    std::vector<size_t> ends;
+    if (column.back() <= k) {
+        ends.push_back(0);
+    }
+    for (size_t j = 1; j <= haystack.size(); j++) {
+        size_t diagonal = column[0];
+        column[0] = 0;
+        for (size_t i = 1; i <= needle.size(); i++) {
+            const auto left = column[i];
+            column[i] = (std::min)({left + 1, column[i - 1] + 1, diagonal + (needle[i - 1] == haystack[j - 1] ? 0 : 1)});
+            diagonal = left;
+        }
+        if (column.back() <= k) {
+            ends.push_back(j);
+        }
+    }
+    return ends;
+}
+
+std::vector<size_t> ends(const andwass::approximate_searcher& searcher, const std::string& haystack) {
+    std::vector<size_t> retval;
+    searcher.for_each_end({haystack.data(), haystack.size()}, [&](size_t end) {
+        retval.push_back(end);
+        return true;
+    });
+    return retval;
+}
+}
+
+TEST(ApproximateSearcher, Basics) {
+    andwass::approximate_searcher exact("world", 0);
+    EXPECT_EQ(exact.find_end("hello world"), 11);
+    EXPECT_FALSE(exact.contains("hello wrold"));
+
+    andwass::approximate_searcher one("connection", 1);
+    EXPECT_TRUE(one.contains("error: conection refused"));
+    EXPECT_TRUE(one.contains("error: connecti0n refused"));
+    EXPECT_TRUE(one.contains("error: connnection refused"));
+    EXPECT_FALSE(one.contains("error: conecton refused"));
+    EXPECT_EQ(one.find_end("conection"), 9);
+
+    andwass::approximate_searcher two("connection", 2);
+    EXPECT_TRUE(two.contains("error: conecton refused"));
+    EXPECT_EQ(two.max_errors(), 2);
+    EXPECT_EQ(two.needle_size(), 10);
+}
+
+TEST(ApproximateSearcher, Limits) {
+    andwass::approximate_searcher all("ab", 5);
+    EXPECT_EQ(all.max_errors(), 2);
+    EXPECT_EQ(all.find_end("xyz"), 0);
+    EXPECT_EQ(ends(all, "xy"), (std::vector<size_t>{0, 1, 2}));
+
+    andwass::approximate_searcher empty("", 0);
+    EXPECT_EQ(empty.find_end(""), 0);
+
+    EXPECT_THROW(andwass::approximate_searcher(std::string(65, 'a').c_str(), 1), std::length_error);
+    andwass::approximate_searcher longest(std::string(64, 'a').c_str(), 1);
+    EXPECT_TRUE(longest.contains(std::string(63, 'a').c_str()));
+    EXPECT_FALSE(longest.contains(std::string(62, 'a').c_str()));
+}
+
+TEST(ApproximateSearcher, AgreesWithDynamicProgramming) {
+    std::mt19937 rng(3);
+    for (int iter = 0; iter < 500; iter++) {
+        std::string needle;
+        const auto needle_len = 1 + rng() % 12;
+        for (size_t i = 0; i < needle_len; i++) {
+            needle += static_cast<char>('a' + rng() % 3);
+        }
+        std::string haystack;
+        const auto haystack_len = rng() % 40;
+        for (size_t i = 0; i < haystack_len; i++) {
+            haystack += static_cast<char>('a' + rng() % 3);
+        }
+        const size_t k = rng() % 4;
+        andwass::approximate_searcher searcher({needle.data(), needle.size()}, k);
+        ASSERT_EQ(ends(searcher, haystack), reference_ends(needle, haystack, (std::min)(k, needle.size()))) << needle << " " << haystack << " " << k;
+    }
+}
+
+#pragma clang diagnostic pop
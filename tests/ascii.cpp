@@ -0,0 +1,91 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/ascii.hpp>
+
+#include <string>
+#include <unordered_map>
+
+TEST(Ascii, CaseConversion) {
+    EXPECT_EQ(andwass::to_lower_ascii('A'), 'a');
+    EXPECT_EQ(andwass::to_lower_ascii('Z'), 'z');
+    EXPECT_EQ(andwass::to_lower_ascii('a'), 'a');
+    EXPECT_EQ(andwass::to_lower_ascii('@'), '@');
+    EXPECT_EQ(andwass::to_lower_ascii('['), '[');
+    EXPECT_EQ(andwass::to_upper_ascii('a'), 'A');
+    EXPECT_EQ(andwass::to_upper_ascii('z'), 'Z');
+    EXPECT_EQ(andwass::to_upper_ascii('`'), '`');
+    EXPECT_EQ(andwass::to_upper_ascii('{'), '{');
+
+    for (int i = 0; i < 256; i++) {
+        const auto ch = static_cast<char>(i);
+        const bool is_upper = i >= 'A' && i <= 'Z';
+        const bool is_lower = i >= 'a' && i <= 'z';
+        EXPECT_EQ(andwass::to_lower_ascii(ch), is_upper ? static_cast<char>(i + 32) : ch);
+        EXPECT_EQ(andwass::to_upper_ascii(ch), is_lower ? static_cast<char>(i - 32) : ch);
+    }
+}
+
+TEST(Ascii, ConvertIntoBuffer) {
+    using andwass::operator""_sv;
+    char buffer[32];
+    EXPECT_EQ(andwass::to_lower_ascii("Content-Type: \xC3\x84"_sv, buffer, sizeof(buffer)), "content-type: \xC3\x84");
+    EXPECT_EQ(andwass::to_upper_ascii("Content-Type"_sv, buffer, sizeof(buffer)), "CONTENT-TYPE");
+    EXPECT_EQ(andwass::to_upper_ascii("Content-Type"_sv, buffer, 4), "CONT");
+    EXPECT_EQ(andwass::to_upper_ascii("Content-Type"_sv, buffer, 4).data(), buffer);
+
+    std::string in_place = "Hello World";
+    EXPECT_EQ(andwass::to_lower_ascii({in_place.data(), in_place.size()}, in_place.data(), in_place.size()), "hello world");
+    EXPECT_EQ(in_place, "hello world");
+}
+
+TEST(Ascii, HashLower) {
+    using andwass::operator""_sv;
+    EXPECT_EQ(andwass::hash_lower("Content-Type"_sv), andwass::hash("content-type"_sv));
+    EXPECT_EQ(andwass::hash_lower(""_sv), andwass::hash(""_sv));
+    EXPECT_NE(andwass::hash_lower("Content-Type"_sv), andwass::hash("Content-Type"_sv));
+
+    std::string all;
+    for (int i = 1; i < 256; i++) {
+        all += static_cast<char>(i);
+    }
+    std::string lower(all.size(), '\0');
+    andwass::to_lower_ascii({all.data(), all.size()}, lower.data(), lower.size());
+    for (size_t len = 0; len <= all.size(); len++) {
+        ASSERT_EQ(andwass::hash_lower({all.data(), len}), andwass::hash({lower.data(), len}));
+    }
+
+    static_assert(andwass::hash_lower("ABC"_sv) == andwass::hash("abc"_sv));
+}
+
+TEST(Ascii, IEquals) {
+    using andwass::operator""_sv;
+    EXPECT_TRUE(andwass::iequals("Content-Type"_sv, "content-type"_sv));
+    EXPECT_TRUE(andwass::iequals("X-REQUEST-ID-WITH-A-LONG-NAME"_sv, "x-request-id-with-a-long-name"_sv));
+    EXPECT_TRUE(andwass::iequals(""_sv, ""_sv));
+    EXPECT_FALSE(andwass::iequals("Content-Type"_sv, "Content-Typ"_sv));
+    EXPECT_FALSE(andwass::iequals("X-REQUEST-ID-WITH-A-LONG-NAMF"_sv, "x-request-id-with-a-long-name"_sv));
+    EXPECT_FALSE(andwass::iequals("@"_sv, "`"_sv));
+    EXPECT_FALSE(andwass::iequals("["_sv, "{"_sv));
+
+    static_assert(andwass::iequals("ABC"_sv, "abc"_sv));
+}
+
+TEST(Ascii, CaseInsensitiveMap) {
+    using andwass::operator""_sv;
+    std::unordered_map<andwass::string_view, int, andwass::ihash, andwass::iequal_to> headers;
+    headers["Content-Type"_sv] = 1;
+    headers["Accept"_sv] = 2;
+
+    EXPECT_EQ(headers.count("content-type"_sv), 1);
+    EXPECT_EQ(headers.count("CONTENT-TYPE"_sv), 1);
+    EXPECT_EQ(headers.at("ACCEPT"_sv), 2);
+    EXPECT_EQ(headers.count("Accept-Encoding"_sv), 0);
+
+    headers["accept"_sv] = 3;
+    EXPECT_EQ(headers.size(), 2);
+    EXPECT_EQ(headers.at("Accept"_sv), 3);
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,105 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/bloom_filter.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+std::vector<std::string> make_keys(const std::string& prefix, int count) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < count; i++) {
+        keys.push_back(prefix + std::to_string(i));
+    }
+    return keys;
+}
+
+std::vector<andwass::string_view> as_views(const std::vector<std::string>& keys) {
+    std::vector<andwass::string_view> views;
+    for (const auto& key: keys) {
+        views.emplace_back(key.data(), key.size());
+    }
+    return views;
+}
+}// namespace
+
+TEST(BlockedBloomFilter, Construction) {
+    andwass::blocked_bloom_filter filter(1000);
+    EXPECT_EQ(filter.num_blocks(), 20);
+    EXPECT_EQ(filter.num_hashes(), 7);
+    EXPECT_FALSE(filter.contains("anything"));
+    EXPECT_THROW(andwass::blocked_bloom_filter(10, 0), std::invalid_argument);
+    EXPECT_THROW(andwass::blocked_bloom_filter(10, 65), std::invalid_argument);
+}
+
+TEST(BlockedBloomFilter, NoFalseNegatives) {
+    const auto keys = make_keys("present-", 10000);
+    const auto views = as_views(keys);
+    andwass::blocked_bloom_filter filter(keys.size());
+    filter.insert(views.begin(), views.end());
+    for (const auto& key: views) {
+        ASSERT_TRUE(filter.contains(key));
+    }
+    std::vector<bool> results;
+    filter.contains(views.begin(), views.end(), std::back_inserter(results));
+    ASSERT_EQ(results.size(), views.size());
+    for (auto r: results) {
+        ASSERT_TRUE(r);
+    }
+
+    filter.clear();
+    EXPECT_FALSE(filter.contains(views[0]));
+}
+
+TEST(BlockedBloomFilter, FalsePositiveRate) {
+    const auto keys = make_keys("present-", 20000);
+    const auto views = as_views(keys);
+    andwass::blocked_bloom_filter filter(keys.size(), 10);
+    for (const auto& key: views) {
+        filter.insert(key);
+    }
+    const auto missing_keys = make_keys("missing-", 100000);
+    const auto missing = as_views(missing_keys);
+    std::vector<bool> results;
+    filter.contains(missing.begin(), missing.end(), std::back_inserter(results));
+    size_t false_positives = 0;
+    for (size_t i = 0; i < missing.size(); i++) {
+        ASSERT_EQ(results[i], filter.contains(missing[i]));
+        false_positives += results[i];
+    }
+    EXPECT_LT(false_positives, missing.size() / 50);
+}
+
+TEST(BlockedBloomFilter, Serialization) {
+    const auto keys = make_keys("key", 500);
+    const auto views = as_views(keys);
+    andwass::blocked_bloom_filter filter(keys.size(), 12);
+    filter.insert(views.begin(), views.end());
+
+    const auto bytes = filter.serialize();
+    EXPECT_EQ(bytes.size(), 24 + filter.num_blocks() * 64);
+    EXPECT_EQ(bytes[0], 'A');
+    const auto copy = andwass::blocked_bloom_filter::deserialize({bytes.data(), bytes.size()});
+    EXPECT_EQ(copy.num_blocks(), filter.num_blocks());
+    EXPECT_EQ(copy.num_hashes(), filter.num_hashes());
+    EXPECT_EQ(copy.serialize(), bytes);
+    for (const auto& key: views) {
+        ASSERT_TRUE(copy.contains(key));
+    }
+
+    EXPECT_THROW(andwass::blocked_bloom_filter::deserialize({bytes.data(), 10}), std::invalid_argument);
+    EXPECT_THROW(andwass::blocked_bloom_filter::deserialize({bytes.data(), bytes.size() - 1}), std::invalid_argument);
+    auto corrupt = bytes;
+    corrupt[0] = 'X';
+    EXPECT_THROW(andwass::blocked_bloom_filter::deserialize({corrupt.data(), corrupt.size()}), std::invalid_argument);
+    corrupt = bytes;
+    corrupt[4] = 2;
+    EXPECT_THROW(andwass::blocked_bloom_filter::deserialize({corrupt.data(), corrupt.size()}), std::invalid_argument);
+    corrupt = bytes;
+    corrupt[8] = 0;
+    EXPECT_THROW(andwass::blocked_bloom_filter::deserialize({corrupt.data(), corrupt.size()}), std::invalid_argument);
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,72 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/count_min_sketch.hpp>
+
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+
+TEST(CountMinSketch, Construction) {
+    andwass::count_min_sketch sketch(1024, 4);
+    EXPECT_EQ(sketch.width(), 1024);
+    EXPECT_EQ(sketch.depth(), 4);
+    EXPECT_EQ(sketch.total(), 0);
+    EXPECT_EQ(sketch.estimate("anything"), 0);
+    EXPECT_THROW(andwass::count_min_sketch(0, 4), std::invalid_argument);
+    EXPECT_THROW(andwass::count_min_sketch(16, 0), std::invalid_argument);
+    if constexpr (sizeof(std::size_t) > 4) {
+        EXPECT_THROW(andwass::count_min_sketch((std::size_t(1) << 32) + 1, 1), std::invalid_argument);
+    }
+    // The product of the dimensions overflows.
+    EXPECT_THROW(andwass::count_min_sketch(std::size_t(1) << 32, (std::numeric_limits<std::size_t>::max)() / 2), std::length_error);
+}
+
+TEST(CountMinSketch, Estimates) {
+    std::mt19937 rng(69);
+    andwass::count_min_sketch sketch(2048, 5);
+    std::map<std::string, std::uint64_t> counts;
+    for (int i = 0; i < 100000; i++) {
+        // Skewed keys, a few are very frequent
+        const auto key = "url-" + std::to_string(rng() % (rng() % 2 ? 10 : 20000));
+        sketch.insert(andwass::string_view(key.data(), key.size()));
+        counts[key]++;
+    }
+    sketch.insert("weighted", 500);
+    counts["weighted"] += 500;
+    EXPECT_EQ(sketch.total(), 100500);
+
+    size_t within_bound = 0;
+    for (const auto& [key, count]: counts) {
+        const auto estimate = sketch.estimate(andwass::string_view(key.data(), key.size()));
+        ASSERT_GE(estimate, count);
+        within_bound += estimate - count <= 3 * sketch.total() / sketch.width();
+    }
+    EXPECT_GE(within_bound, counts.size() * 99 / 100);
+    EXPECT_LE(sketch.estimate("url-3"), counts["url-3"] + 3 * sketch.total() / sketch.width());
+}
+
+TEST(CountMinSketch, Merge) {
+    andwass::count_min_sketch a(256, 3), b(256, 3), all(256, 3);
+    for (int i = 0; i < 1000; i++) {
+        const auto key = std::to_string(i % 37);
+        (i % 2 ? a : b).insert(andwass::string_view(key.data(), key.size()));
+        all.insert(andwass::string_view(key.data(), key.size()));
+    }
+    a.merge(b);
+    EXPECT_EQ(a.total(), all.total());
+    for (int i = 0; i < 37; i++) {
+        const auto key = std::to_string(i);
+        EXPECT_EQ(a.estimate(andwass::string_view(key.data(), key.size())), all.estimate(andwass::string_view(key.data(), key.size())));
+    }
+    EXPECT_THROW(a.merge(andwass::count_min_sketch(256, 4)), std::invalid_argument);
+    EXPECT_THROW(a.merge(andwass::count_min_sketch(128, 3)), std::invalid_argument);
+
+    a.clear();
+    EXPECT_EQ(a.total(), 0);
+    EXPECT_EQ(a.estimate("1"), 0);
+}
+
+#pragma clang diagnostic pop
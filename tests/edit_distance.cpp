@@ -0,0 +1,90 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/edit_distance.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+size_t reference_distance(const std::string& a, const std::string& b) {
+    std::vector<size_t> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++) {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= a.size(); i++) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); j++) {
+            const auto above = row[j];
+            row[j] = (std::min)({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+andwass::string_view view(const std::string& str) {
+    return {str.data(), str.size()};
+}
+}
+
+TEST(EditDistance, Basics) {
+    EXPECT_EQ(andwass::edit_distance("", ""), 0);
+    EXPECT_EQ(andwass::edit_distance("abc", ""), 3);
+    EXPECT_EQ(andwass::edit_distance("", "abc"), 3);
+    EXPECT_EQ(andwass::edit_distance("abc", "abc"), 0);
+    EXPECT_EQ(andwass::edit_distance("kitten", "sitting"), 3);
+    EXPECT_EQ(andwass::edit_distance("sitting", "kitten"), 3);
+    EXPECT_EQ(andwass::edit_distance("flaw", "lawn"), 2);
+    EXPECT_EQ(andwass::edit_distance("connection refused", "conection refused"), 1);
+}
+
+TEST(EditDistance, MaxK) {
+    EXPECT_EQ(andwass::edit_distance("kitten", "sitting", 3), 3);
+    EXPECT_EQ(andwass::edit_distance("kitten", "sitting", 2), andwass::string_view::npos);
+    EXPECT_EQ(andwass::edit_distance("a", "abcdef", 4), andwass::string_view::npos);
+    EXPECT_EQ(andwass::edit_distance("abc", "abc", 0), 0);
+
+    const std::string long_a(1000, 'a');
+    const std::string long_b(1000, 'b');
+    EXPECT_EQ(andwass::edit_distance(view(long_a), view(long_b), 10), andwass::string_view::npos);
+    EXPECT_EQ(andwass::edit_distance(view(long_a), view(long_b)), 1000);
+}
+
+TEST(EditDistance, AgreesWithDynamicProgramming) {
+    std::mt19937 rng(7);
+    for (int iter = 0; iter < 400; iter++) {
+        // Cover single and multi block patterns, and both block boundaries.
+        const size_t len_a = rng() % 200;
+        const size_t len_b = iter % 4 == 0 ? len_a : rng() % 200;
+        const int alphabet = 2 + static_cast<int>(rng() % 4);
+        std::string a;
+        std::string b;
+        for (size_t i = 0; i < len_a; i++) {
+            a += static_cast<char>('a' + rng() % alphabet);
+        }
+        for (size_t i = 0; i < len_b; i++) {
+            b += static_cast<char>('a' + rng() % alphabet);
+        }
+        const auto expected = reference_distance(a, b);
+        ASSERT_EQ(andwass::edit_distance(view(a), view(b)), expected) << a << " " << b;
+        ASSERT_EQ(andwass::edit_distance(view(a), view(b), expected), expected);
+        if (expected > 0) {
+            ASSERT_EQ(andwass::edit_distance(view(a), view(b), expected - 1), andwass::string_view::npos);
+        }
+    }
+
+    for (size_t len : {63, 64, 65, 127, 128, 129}) {
+        std::string a(len, 'x');
+        std::string b = a;
+        b[len / 2] = 'y';
+        b.insert(b.begin(), 'z');
+        ASSERT_EQ(andwass::edit_distance(view(a), view(b)), reference_distance(a, b));
+    }
+}
+
+#pragma clang diagnostic pop
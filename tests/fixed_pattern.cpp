@@ -0,0 +1,95 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/fixed_pattern.hpp>
+#include <andwass/regex.hpp>
+
+#include <random>
+#include <string>
+
+namespace {
+constexpr andwass::fixed_pattern version("v\\d+\\.\\d+");
+constexpr andwass::fixed_pattern hex_id("0x[0-9a-fA-F]+");
+constexpr andwass::fixed_pattern identifier("[a-zA-Z_]\\w*");
+}
+
+TEST(FixedPattern, CompileTime) {
+    static_assert(version.size() == 4);
+    static_assert(version.match("v1.22"));
+    static_assert(!version.match("v1."));
+    static_assert(!version.match("1.22"));
+    static_assert(version.search("release v1.22 is out"));
+    static_assert(!version.search("release 1.22 is out"));
+
+    static_assert(hex_id.match("0xdeadBEEF"));
+    static_assert(!hex_id.match("0x"));
+    static_assert(identifier.match("_private9"));
+    static_assert(!identifier.match("9lives"));
+
+    static_assert(andwass::fixed_pattern("colou?r").match("color"));
+    static_assert(andwass::fixed_pattern("colou?r").match("colour"));
+    static_assert(andwass::fixed_pattern("a*").match(""));
+    static_assert(andwass::fixed_pattern("").match(""));
+    static_assert(!andwass::fixed_pattern("").match("a"));
+    static_assert(andwass::fixed_pattern("").search("a"));
+    EXPECT_TRUE(version.match("v10.0"));
+}
+
+TEST(FixedPattern, Classes) {
+    EXPECT_TRUE(andwass::fixed_pattern("[^0-9]+").match("abc"));
+    EXPECT_FALSE(andwass::fixed_pattern("[^0-9]+").match("a1c"));
+    EXPECT_TRUE(andwass::fixed_pattern("[]a]+").match("]a]"));
+    EXPECT_TRUE(andwass::fixed_pattern("[a-]+").match("a-a"));
+    EXPECT_TRUE(andwass::fixed_pattern("[\\d.]+").match("1.5"));
+    EXPECT_TRUE(andwass::fixed_pattern("\\s\\S\\W").match(" a!"));
+    EXPECT_TRUE(andwass::fixed_pattern("a\\*").match("a*"));
+    EXPECT_FALSE(andwass::fixed_pattern("a.c").match("a\nc"));
+    EXPECT_TRUE(andwass::fixed_pattern("a.c").match("a\tc"));
+    EXPECT_TRUE(andwass::fixed_pattern("a\\nb\\tc\\r").match("a\nb\tc\r"));
+    EXPECT_FALSE(andwass::fixed_pattern("a\\n").match("an"));
+    EXPECT_TRUE(andwass::fixed_pattern("[\\n\\t]+").match("\t\n"));
+}
+
+TEST(FixedPattern, InvalidPatterns) {
+    EXPECT_THROW(andwass::fixed_pattern("*a"), std::invalid_argument);
+    EXPECT_THROW(andwass::fixed_pattern("[abc"), std::invalid_argument);
+    EXPECT_THROW(andwass::fixed_pattern("[z-a]"), std::invalid_argument);
+    EXPECT_THROW(andwass::fixed_pattern("(a)"), std::invalid_argument);
+    EXPECT_THROW(andwass::fixed_pattern("a|b"), std::invalid_argument);
+    EXPECT_THROW(andwass::fixed_pattern("a\\"), std::invalid_argument);
+    EXPECT_THROW(andwass::fixed_pattern("0123456789012345678901234567890123456789012345678901234567890123"), std::length_error);
+    EXPECT_NO_THROW(andwass::fixed_pattern("012345678901234567890123456789012345678901234567890123456789012"));
+}
+
+TEST(FixedPattern, AgreesWithRegex) {
+    // Patterns must be literals, so test a fixed set against many random texts.
+    constexpr andwass::fixed_pattern p0("a*b+a?");
+    constexpr andwass::fixed_pattern p1(".a*.b?c");
+    constexpr andwass::fixed_pattern p2("[ab]*c+[^a]?");
+    constexpr andwass::fixed_pattern p3("a?a?a?aaa");
+    const andwass::regex r0("a*b+a?");
+    const andwass::regex r1(".a*.b?c");
+    const andwass::regex r2("[ab]*c+[^a]?");
+    const andwass::regex r3("a?a?a?aaa");
+
+    std::mt19937 rng(99);
+    for (int iter = 0; iter < 3000; iter++) {
+        std::string text;
+        const auto len = rng() % 9;
+        for (size_t i = 0; i < len; i++) {
+            text += "abc\n"[rng() % 4];
+        }
+        const andwass::string_view sv(text.data(), text.size());
+        ASSERT_EQ(p0.match(sv), r0.match(sv)) << text;
+        ASSERT_EQ(p1.match(sv), r1.match(sv)) << text;
+        ASSERT_EQ(p2.match(sv), r2.match(sv)) << text;
+        ASSERT_EQ(p3.match(sv), r3.match(sv)) << text;
+        ASSERT_EQ(p0.search(sv), r0.search(sv)) << text;
+        ASSERT_EQ(p1.search(sv), r1.search(sv)) << text;
+        ASSERT_EQ(p2.search(sv), r2.search(sv)) << text;
+        ASSERT_EQ(p3.search(sv), r3.search(sv)) << text;
+    }
+}
+
+#pragma clang diagnostic pop
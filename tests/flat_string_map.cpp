@@ -0,0 +1,188 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/flat_string_map.hpp>
+
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+andwass::string_view as_view(const std::string& str) {
+    return andwass::string_view(str.data(), str.size());
+}
+
+// Copies throw once `copies_left` runs out, and the move constructor may throw so rehashing copies.
+struct throwing_copy {
+    static inline int copies_left = -1;
+    int value;
+
+    explicit throwing_copy(int v): value(v) {}
+    throwing_copy(const throwing_copy& rhs): value(rhs.value) {
+        if (copies_left == 0) {
+            throw std::runtime_error("copy");
+        }
+        --copies_left;
+    }
+    throwing_copy(throwing_copy&& rhs) noexcept(false): value(rhs.value) {}
+};
+}// namespace
+
+TEST(FlatStringMap, Basic) {
+    andwass::flat_string_map<int> map;
+    EXPECT_TRUE(map.is_empty());
+    EXPECT_EQ(map.find("missing"), nullptr);
+    EXPECT_FALSE(map.erase("missing"));
+
+    auto [value, inserted] = map.try_emplace("short", 1);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(*value, 1);
+    EXPECT_FALSE(map.try_emplace("short", 2).second);
+    EXPECT_EQ(*map.find("short"), 1);
+
+    map["a key that is longer than twelve chars"] = 5;
+    map[""] = 7;
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(*map.find("a key that is longer than twelve chars"), 5);
+    EXPECT_EQ(*map.find(""), 7);
+    EXPECT_FALSE(map.contains("a key that is longer than twelve chars!"));
+    EXPECT_FALSE(map.try_emplace_hashed("short", andwass::hash("short"), 3).second);
+    EXPECT_TRUE(map.try_emplace_hashed("hashed", andwass::hash("hashed"), 4).second);
+    EXPECT_EQ(*map.find("hashed"), 4);
+    EXPECT_TRUE(map.erase("hashed"));
+
+    EXPECT_TRUE(map.erase("short"));
+    EXPECT_FALSE(map.contains("short"));
+    EXPECT_EQ(map.size(), 2);
+
+    map.clear();
+    EXPECT_TRUE(map.is_empty());
+    EXPECT_FALSE(map.contains(""));
+}
+
+TEST(FlatStringMap, KeysAreCopied) {
+    andwass::flat_string_map<int> map;
+    {
+        std::string key = "temporary key with a long body";
+        map[as_view(key)] = 1;
+        key.assign(key.size(), 'x');
+    }
+    EXPECT_TRUE(map.contains("temporary key with a long body"));
+    std::string huge(20000, 'h');
+    map[as_view(huge)] = 2;
+    EXPECT_EQ(*map.find(as_view(huge)), 2);
+
+    auto moved = std::move(map);
+    EXPECT_TRUE(moved.contains("temporary key with a long body"));
+    EXPECT_TRUE(map.is_empty());
+}
+
+TEST(FlatStringMap, NonTrivialValues) {
+    andwass::flat_string_map<std::unique_ptr<std::string>> map;
+    for (int i = 0; i < 1000; i++) {
+        const auto key = "key" + std::to_string(i);
+        map.try_emplace(as_view(key), std::make_unique<std::string>(key));
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        const auto key = "key" + std::to_string(i);
+        ASSERT_TRUE(map.erase(as_view(key)));
+    }
+    size_t visited = 0;
+    map.for_each([&](andwass::string_view key, std::unique_ptr<std::string>& value) {
+        ASSERT_EQ(key, as_view(*value));
+        ++visited;
+    });
+    EXPECT_EQ(visited, 500);
+}
+
+TEST(FlatStringMap, RehashThrowLeavesMapUnchanged) {
+    andwass::flat_string_map<throwing_copy> map;
+    int count = 0;
+    while (map.size() * 8 < map.capacity() * 7 || map.size() == 0) {
+        const auto key = "a long key number " + std::to_string(count);
+        map.try_emplace(as_view(key), count);
+        ++count;
+    }
+    const auto capacity = map.capacity();
+
+    throwing_copy::copies_left = 3;
+    EXPECT_THROW(map.try_emplace("one more", -1), std::runtime_error);
+    throwing_copy::copies_left = -1;
+
+    EXPECT_EQ(map.capacity(), capacity);
+    EXPECT_EQ(map.size(), count);
+    EXPECT_FALSE(map.contains("one more"));
+    for (int i = 0; i < count; i++) {
+        const auto key = "a long key number " + std::to_string(i);
+        ASSERT_NE(map.find(as_view(key)), nullptr);
+        EXPECT_EQ(map.find(as_view(key))->value, i);
+    }
+
+    map.try_emplace("one more", -1);
+    EXPECT_GT(map.capacity(), capacity);
+    EXPECT_EQ(map.find("one more")->value, -1);
+}
+
+TEST(FlatStringMap, Reserve) {
+    andwass::flat_string_map<int> map;
+    map.reserve(1000);
+    const auto capacity = map.capacity();
+    EXPECT_GE(capacity * 7 / 8, 1000);
+    for (int i = 0; i < 1000; i++) {
+        map[as_view(std::to_string(i))] = i;
+    }
+    EXPECT_EQ(map.capacity(), capacity);
+
+    EXPECT_THROW(map.reserve((std::numeric_limits<size_t>::max)()), std::length_error);
+    EXPECT_EQ(map.capacity(), capacity);
+    EXPECT_EQ(map.size(), 1000);
+}
+
+TEST(FlatStringMap, RandomAgainstStdMap) {
+    std::mt19937 rng(67);
+    andwass::flat_string_map<int> map;
+    std::map<std::string, int> reference;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 3000; i++) {
+        std::string key;
+        const auto len = rng() % 24;
+        for (size_t j = 0; j < len; j++) {
+            key += static_cast<char>('a' + rng() % 3);
+        }
+        keys.push_back(key);
+    }
+    for (int i = 0; i < 50000; i++) {
+        const auto& key = keys[rng() % keys.size()];
+        switch (rng() % 4) {
+        case 0:
+            ASSERT_EQ(map.erase(as_view(key)), reference.erase(key) == 1);
+            break;
+        case 1:
+            map[as_view(key)] = i;
+            reference[key] = i;
+            break;
+        default: {
+            const auto* value = map.find(as_view(key));
+            const auto it = reference.find(key);
+            ASSERT_EQ(value != nullptr, it != reference.end());
+            if (value) {
+                ASSERT_EQ(*value, it->second);
+            }
+        }
+        }
+        ASSERT_EQ(map.size(), reference.size());
+    }
+    std::map<std::string, int> visited;
+    const auto& cmap = map;
+    cmap.for_each([&](andwass::string_view key, const int& value) {
+        visited.emplace(std::string(key.data(), key.size()), value);
+    });
+    EXPECT_EQ(visited, reference);
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,121 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/fm_index.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+std::string random_text(std::mt19937& rng, size_t size, unsigned alphabet) {
+    std::string text;
+    for (size_t i = 0; i < size; i++) {
+        text += static_cast<char>(alphabet == 256 ? rng() % 256 : 'a' + rng() % alphabet);
+    }
+    return text;
+}
+
+std::vector<size_t> naive_find_all(const std::string& text, const std::string& needle) {
+    std::vector<size_t> retval;
+    for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        retval.push_back(pos);
+    }
+    return retval;
+}
+
+andwass::string_view as_view(const std::string& str) {
+    return andwass::string_view(str.data(), str.size());
+}
+}// namespace
+
+TEST(FmIndex, Basic) {
+    andwass::fm_index index("mississippi", 3);
+    EXPECT_EQ(index.size(), 11);
+    EXPECT_EQ(index.sample_rate(), 3);
+    EXPECT_EQ(index.count("ssi"), 2);
+    EXPECT_EQ(index.count("i"), 4);
+    EXPECT_EQ(index.count("mississippi"), 1);
+    EXPECT_EQ(index.count("mississippis"), 0);
+    EXPECT_EQ(index.count("x"), 0);
+    EXPECT_EQ(index.count(""), 11);
+    EXPECT_TRUE(index.contains("sip"));
+    EXPECT_EQ(index.locate("issi"), (std::vector<size_t>{1, 4}));
+    EXPECT_EQ(index.locate("").size(), 11);
+    EXPECT_EQ(index.locate("").back(), 10);
+
+    EXPECT_THROW(andwass::fm_index("abc", 0), std::invalid_argument);
+}
+
+TEST(FmIndex, EmptyAndZeroBytes) {
+    andwass::fm_index empty("");
+    EXPECT_EQ(empty.count("a"), 0);
+    EXPECT_EQ(empty.count(""), 0);
+
+    const std::string text("a\0b\0\0a", 6);
+    andwass::fm_index index(as_view(text), 1);
+    EXPECT_EQ(index.count(andwass::string_view("\0", 1)), 3);
+    EXPECT_EQ(index.locate(andwass::string_view("\0\0", 2)), std::vector<size_t>{3});
+    EXPECT_EQ(index.locate(andwass::string_view("\0a", 2)), std::vector<size_t>{4});
+}
+
+TEST(FmIndex, RandomAgainstNaive) {
+    std::mt19937 rng(73);
+    for (int iter = 0; iter < 100; iter++) {
+        const unsigned alphabet = iter % 4 == 3 ? 256 : 1 + iter % 4;
+        const auto text = random_text(rng, rng() % 2000, alphabet);
+        andwass::fm_index index(as_view(text), 1 + rng() % 40);
+        for (int q = 0; q < 20; q++) {
+            std::string needle;
+            if (q % 2 == 0 && !text.empty()) {
+                const auto pos = rng() % text.size();
+                needle = text.substr(pos, 1 + rng() % 6);
+            }
+            else {
+                needle = random_text(rng, 1 + rng() % 4, alphabet);
+            }
+            const auto expected = naive_find_all(text, needle);
+            ASSERT_EQ(index.count(as_view(needle)), expected.size());
+            ASSERT_EQ(index.locate(as_view(needle)), expected);
+        }
+    }
+}
+
+TEST(FmIndex, Load) {
+    std::mt19937 rng(731);
+    const auto text = random_text(rng, 5000, 4);
+    andwass::fm_index built(as_view(text), 8);
+    const std::vector<std::uint64_t> words(built.data(), built.data() + built.data_size());
+
+    const auto loaded = andwass::fm_index::load(words.data(), words.size());
+    EXPECT_EQ(loaded.data(), words.data());
+    EXPECT_EQ(loaded.size(), text.size());
+    EXPECT_EQ(loaded.locate("abca"), naive_find_all(text, "abca"));
+
+    auto moved = std::move(built);
+    EXPECT_EQ(moved.locate("dd"), naive_find_all(text, "dd"));
+
+    EXPECT_THROW(andwass::fm_index::load(words.data(), 3), std::invalid_argument);
+    EXPECT_THROW(andwass::fm_index::load(words.data(), words.size() - 1), std::invalid_argument);
+    auto corrupt = words;
+    corrupt[0] ^= 1;
+    EXPECT_THROW(andwass::fm_index::load(corrupt.data(), corrupt.size()), std::invalid_argument);
+    corrupt = words;
+    corrupt[2] += 1000;
+    EXPECT_THROW(andwass::fm_index::load(corrupt.data(), corrupt.size()), std::invalid_argument);
+    // A text size whose layout would wrap around.
+    corrupt = words;
+    corrupt[2] = ~std::uint64_t(0) - 1;
+    EXPECT_THROW(andwass::fm_index::load(corrupt.data(), corrupt.size()), std::invalid_argument);
+
+    // Symbol counts, bottom positions and level zero counts, which queries use as indices.
+    const size_t header = 6;
+    for (const size_t word: {header + 'b', header + 257 + 'a', header + 257 + 256 + 3}) {
+        corrupt = words;
+        corrupt[word] += 1u << 20;
+        EXPECT_THROW(andwass::fm_index::load(corrupt.data(), corrupt.size()), std::invalid_argument) << word;
+    }
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,173 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/glob.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+bool both_match(andwass::string_view pattern, andwass::string_view text) {
+    const bool expected = andwass::glob_match(pattern, text);
+    EXPECT_EQ(andwass::glob(pattern).matches(text), expected)
+        << std::string(pattern.data(), pattern.size()) << " " << std::string(text.data(), text.size());
+    return expected;
+}
+}
+
+TEST(Glob, Basics) {
+    EXPECT_TRUE(both_match("", ""));
+    EXPECT_FALSE(both_match("", "a"));
+    EXPECT_TRUE(both_match("*", ""));
+    EXPECT_TRUE(both_match("*", "abc"));
+    EXPECT_TRUE(both_match("**", "abc"));
+    EXPECT_TRUE(both_match("abc", "abc"));
+    EXPECT_FALSE(both_match("abc", "abcd"));
+    EXPECT_FALSE(both_match("abcd", "abc"));
+    EXPECT_TRUE(both_match("a?c", "abc"));
+    EXPECT_FALSE(both_match("a?c", "ac"));
+    EXPECT_TRUE(both_match("a*", "abc"));
+    EXPECT_TRUE(both_match("*c", "abc"));
+    EXPECT_TRUE(both_match("a*c", "ac"));
+    EXPECT_FALSE(both_match("a*c", "ab"));
+    EXPECT_TRUE(both_match("a*b*c", "aXbYbZc"));
+    EXPECT_FALSE(both_match("a*b*c", "aXcYb"));
+    EXPECT_FALSE(both_match("ab*ba", "aba"));
+    EXPECT_TRUE(both_match("ab*ba", "abba"));
+}
+
+TEST(Glob, MetricNames) {
+    EXPECT_TRUE(both_match("http.*.latency_p??", "http.frontend.latency_p99"));
+    EXPECT_TRUE(both_match("http.*.latency_p??", "http.a.b.latency_p50"));
+    EXPECT_FALSE(both_match("http.*.latency_p??", "http.frontend.latency_p999"));
+    EXPECT_FALSE(both_match("http.*.latency_p??", "grpc.frontend.latency_p99"));
+}
+
+TEST(Glob, CharacterClasses) {
+    EXPECT_TRUE(both_match("[abc]", "b"));
+    EXPECT_FALSE(both_match("[abc]", "d"));
+    EXPECT_TRUE(both_match("p[0-9][0-9]", "p95"));
+    EXPECT_FALSE(both_match("p[0-9][0-9]", "p9x"));
+    EXPECT_TRUE(both_match("[!0-9]x", "ax"));
+    EXPECT_FALSE(both_match("[^0-9]x", "5x"));
+    EXPECT_TRUE(both_match("[]]", "]"));
+    EXPECT_TRUE(both_match("[!]]", "a"));
+    EXPECT_FALSE(both_match("[!]]", "]"));
+    EXPECT_TRUE(both_match("[a-]", "-"));
+    EXPECT_TRUE(both_match("[x]*", "xyz"));
+    EXPECT_TRUE(both_match("[", "["));
+    EXPECT_TRUE(both_match("a[b", "a[b"));
+}
+
+TEST(Glob, Escapes) {
+    EXPECT_TRUE(both_match("\\*", "*"));
+    EXPECT_FALSE(both_match("\\*", "a"));
+    EXPECT_TRUE(both_match("a\\?", "a?"));
+    EXPECT_FALSE(both_match("a\\?", "ab"));
+    EXPECT_TRUE(both_match("*\\*", "abc*"));
+    EXPECT_FALSE(both_match("*\\*", "abc"));
+    EXPECT_TRUE(both_match("\\\\*", "\\abc"));
+    EXPECT_TRUE(both_match("a\\", "a\\"));
+}
+
+TEST(Glob, NoExponentialBacktracking) {
+    const std::string text(10000, 'a');
+    const std::string pattern = "*a*a*a*a*a*a*a*a*a*a*b";
+    EXPECT_FALSE(both_match({pattern.data(), pattern.size()}, {text.data(), text.size()}));
+}
+
+TEST(Glob, Randomized) {
+    // Compare against a naive recursive matcher on small inputs.
+    struct reference {
+        static bool match(const std::string& p, size_t pi, const std::string& t, size_t ti) {
+            if (pi == p.size()) {
+                return ti == t.size();
+            }
+            if (p[pi] == '*') {
+                for (size_t k = ti; k <= t.size(); k++) {
+                    if (match(p, pi + 1, t, k)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            if (ti == t.size()) {
+                return false;
+            }
+            const bool ok = p[pi] == '?' || (p[pi] == '[' ? (t[ti] == 'a' || t[ti] == 'b') : p[pi] == t[ti]);
+            const size_t next = p[pi] == '[' ? pi + 4 : pi + 1;
+            return ok && match(p, next, t, ti + 1);
+        }
+    };
+    std::mt19937 rng(1234);
+    const char pattern_chars[] = {'a', 'b', 'c', '*', '?', '['};
+    for (int iter = 0; iter < 2000; iter++) {
+        std::string pattern;
+        const auto pattern_len = rng() % 7;
+        for (size_t i = 0; i < pattern_len; i++) {
+            const char ch = pattern_chars[rng() % sizeof(pattern_chars)];
+            pattern += ch == '[' ? "[ab]" : std::string(1, ch);
+        }
+        std::string text;
+        const auto text_len = rng() % 8;
+        for (size_t i = 0; i < text_len; i++) {
+            text += static_cast<char>('a' + rng() % 3);
+        }
+        ASSERT_EQ(both_match({pattern.data(), pattern.size()}, {text.data(), text.size()}), reference::match(pattern, 0, text, 0))
+            << pattern << " " << text;
+    }
+}
+
+TEST(GlobSet, Matches) {
+    andwass::glob_set set{
+        "http.*.latency_p??",
+        "http.*",
+        "*.latency_*",
+        "grpc.*",
+        "*",
+        "???",
+        "*.errors",
+        "[hg]*.latency_p99",
+    };
+    EXPECT_EQ(set.size(), 8);
+    EXPECT_EQ(set.matches("http.frontend.latency_p99"), (std::vector<size_t>{0, 1, 2, 4, 7}));
+    EXPECT_EQ(set.matches("grpc.backend.errors"), (std::vector<size_t>{3, 4, 6}));
+    EXPECT_EQ(set.matches("abc"), (std::vector<size_t>{4, 5}));
+    EXPECT_EQ(set.matches(""), (std::vector<size_t>{4}));
+
+    std::vector<size_t> ids{100};
+    set.matches("x.latency_p50", ids);
+    EXPECT_EQ(ids, (std::vector<size_t>{100, 2, 4}));
+    EXPECT_EQ(set[2].pattern(), "*.latency_*");
+
+    EXPECT_TRUE(andwass::glob_set().matches("abc").empty());
+}
+
+TEST(GlobSet, AgreesWithGlobMatch) {
+    std::vector<std::string> patterns;
+    for (int i = 0; i < 200; i++) {
+        patterns.push_back("svc" + std::to_string(i % 20) + ".*.m" + std::to_string(i % 7) + (i % 3 == 0 ? "?" : "*"));
+    }
+    patterns.push_back("*");
+    patterns.push_back("svc1?.*");
+    std::vector<andwass::string_view> views;
+    for (const auto& pattern: patterns) {
+        views.emplace_back(pattern.data(), pattern.size());
+    }
+    andwass::glob_set set(views.begin(), views.end());
+
+    for (int i = 0; i < 300; i++) {
+        const auto text = "svc" + std::to_string(i % 23) + ".host" + std::to_string(i) + ".m" + std::to_string(i % 11) + (i % 2 ? "x" : "");
+        std::vector<size_t> expected;
+        for (size_t id = 0; id < patterns.size(); id++) {
+            if (andwass::glob_match({patterns[id].data(), patterns[id].size()}, {text.data(), text.size()})) {
+                expected.push_back(id);
+            }
+        }
+        ASSERT_EQ(set.matches({text.data(), text.size()}), expected) << text;
+    }
+}
+
+#pragma clang diagnostic pop
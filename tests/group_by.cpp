@@ -0,0 +1,90 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/group_by.hpp>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+struct records {
+    std::vector<std::string> storage;
+    std::vector<andwass::string_view> keys;
+    std::vector<int> values;
+};
+
+records make_records(size_t count, int distinct) {
+    std::mt19937 rng(71);
+    records retval;
+    retval.storage.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const auto id = static_cast<int>(rng() % static_cast<unsigned>(distinct));
+        retval.storage.push_back(id % 3 == 0 ? "a/rather/long/key/" + std::to_string(id) : std::to_string(id));
+        retval.values.push_back(static_cast<int>(rng() % 100) - 50);
+    }
+    for (const auto& str: retval.storage) {
+        retval.keys.emplace_back(str.data(), str.size());
+    }
+    return retval;
+}
+
+template<class V>
+std::map<std::string, V> to_std_map(const andwass::partitioned_string_map<V>& map) {
+    std::map<std::string, V> retval;
+    map.for_each([&](andwass::string_view key, const V& value) {
+        retval.emplace(std::string(key.data(), key.size()), value);
+    });
+    return retval;
+}
+}// namespace
+
+TEST(GroupBy, Empty) {
+    std::vector<andwass::string_view> keys;
+    EXPECT_TRUE(andwass::count_by_key(keys.begin(), keys.end()).is_empty());
+}
+
+TEST(GroupBy, SmallInputIsSequential) {
+    const char* keys[] = {"a", "b", "a", "c", "a"};
+    const auto counts = andwass::count_by_key(std::begin(keys), std::end(keys), 8);
+    EXPECT_EQ(counts.size(), 3);
+    EXPECT_EQ(*counts.find("a"), 3);
+    EXPECT_EQ(*counts.find("b"), 1);
+    EXPECT_EQ(*counts.find("c"), 1);
+}
+
+TEST(GroupBy, CountByKey) {
+    const auto recs = make_records(200000, 5000);
+    std::map<std::string, std::uint64_t> expected;
+    for (const auto& str: recs.storage) {
+        expected[str]++;
+    }
+    for (unsigned threads: {1u, 2u, 3u, 8u, 0u}) {
+        const auto counts = andwass::count_by_key(recs.keys.begin(), recs.keys.end(), threads);
+        EXPECT_EQ(to_std_map(counts), expected) << threads;
+        EXPECT_EQ(counts.size(), expected.size()) << threads;
+        for (std::size_t p = 0; p < counts.partition_count(); p++) {
+            counts.partition(p).for_each([&](andwass::string_view key, const std::uint64_t&) {
+                EXPECT_EQ(counts.partition_of(key), p);
+            });
+        }
+        EXPECT_EQ(*counts.find(recs.keys[0]), expected[recs.storage[0]]);
+        EXPECT_EQ(counts.find("missing"), nullptr);
+    }
+}
+
+TEST(GroupBy, SumByKey) {
+    const auto recs = make_records(100000, 20000);
+    std::map<std::string, int> expected;
+    for (size_t i = 0; i < recs.storage.size(); i++) {
+        expected[recs.storage[i]] += recs.values[i];
+    }
+    for (unsigned threads: {1u, 4u, 0u}) {
+        const auto sums = andwass::sum_by_key(recs.keys.begin(), recs.keys.end(), recs.values.begin(), threads);
+        EXPECT_EQ(to_std_map(sums), expected) << threads;
+    }
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,169 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/heavy_hitters.hpp>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+andwass::string_view as_view(const std::string& str) {
+    return andwass::string_view(str.data(), str.size());
+}
+
+std::vector<std::string> zipf_stream(unsigned seed, size_t length, int distinct) {
+    std::mt19937 rng(seed);
+    std::vector<double> weights;
+    for (int i = 1; i <= distinct; i++) {
+        weights.push_back(1.0 / i);
+    }
+    std::discrete_distribution<int> dist(weights.begin(), weights.end());
+    std::vector<std::string> stream;
+    for (size_t i = 0; i < length; i++) {
+        stream.push_back("/path/" + std::to_string(dist(rng)));
+    }
+    return stream;
+}
+
+void check_invariants(const andwass::heavy_hitters& hh, const std::map<std::string, std::uint64_t>& counts, bool merged = false) {
+    const auto all = hh.top(hh.capacity());
+    ASSERT_EQ(all.size(), hh.size());
+    std::uint64_t sum = 0;
+    for (size_t i = 0; i < all.size(); i++) {
+        if (i > 0) {
+            ASSERT_GE(all[i - 1].count, all[i].count);
+        }
+        const auto it = counts.find(std::string(all[i].key.data(), all[i].key.size()));
+        const auto actual = it == counts.end() ? 0 : it->second;
+        ASSERT_GE(all[i].count, actual);
+        ASSERT_LE(all[i].count - all[i].error, actual);
+        sum += all[i].count;
+    }
+    if (!merged) {
+        ASSERT_EQ(sum, hh.total());
+    }
+    for (const auto& [key, count]: counts) {
+        if (count > hh.total() / hh.capacity()) {
+            ASSERT_GT(hh.find(as_view(key)).count, 0) << key;
+        }
+    }
+}
+}// namespace
+
+TEST(HeavyHitters, Basic) {
+    andwass::heavy_hitters hh(2);
+    EXPECT_THROW(andwass::heavy_hitters(0), std::invalid_argument);
+    EXPECT_TRUE(hh.top(5).empty());
+    hh.insert("a");
+    hh.insert("a");
+    hh.insert("b");
+    hh.insert("c");
+    EXPECT_EQ(hh.size(), 2);
+    EXPECT_EQ(hh.total(), 4);
+
+    EXPECT_EQ(hh.top(2).size(), 2);
+    EXPECT_EQ(hh.find("a").count, 2);
+    EXPECT_EQ(hh.find("a").error, 0);
+    EXPECT_EQ(hh.find("c").count, 2);
+    EXPECT_EQ(hh.find("c").error, 1);
+    EXPECT_EQ(hh.find("b").count, 0);
+
+    hh.insert("c", 10);
+    EXPECT_EQ(hh.top(1)[0].key, "c");
+    EXPECT_EQ(hh.top(1)[0].count, 12);
+
+    hh.clear();
+    EXPECT_EQ(hh.size(), 0);
+    EXPECT_EQ(hh.total(), 0);
+}
+
+TEST(HeavyHitters, ZipfStream) {
+    const auto stream = zipf_stream(70, 50000, 5000);
+    andwass::heavy_hitters hh(100);
+    std::map<std::string, std::uint64_t> counts;
+    for (size_t i = 0; i < stream.size(); i++) {
+        hh.insert(as_view(stream[i]), i % 7 == 0 ? 3 : 1);
+        counts[stream[i]] += i % 7 == 0 ? 3 : 1;
+    }
+    check_invariants(hh, counts);
+
+    const auto top = hh.top(3);
+    ASSERT_EQ(top.size(), 3);
+    EXPECT_EQ(top[0].key, "/path/0");
+    EXPECT_EQ(top[1].key, "/path/1");
+    EXPECT_EQ(top[2].key, "/path/2");
+}
+
+TEST(HeavyHitters, Merge) {
+    const auto stream = zipf_stream(71, 40000, 3000);
+    andwass::heavy_hitters a(50), b(50);
+    std::map<std::string, std::uint64_t> counts;
+    for (size_t i = 0; i < stream.size(); i++) {
+        (i < stream.size() / 2 ? a : b).insert(as_view(stream[i]));
+        counts[stream[i]]++;
+    }
+    a.merge(b);
+    EXPECT_EQ(a.total(), stream.size());
+    check_invariants(a, counts, true);
+    EXPECT_EQ(a.top(1)[0].key, "/path/0");
+
+    andwass::heavy_hitters small(10);
+    small.insert("x", 5);
+    small.merge(andwass::heavy_hitters(10));
+    EXPECT_EQ(small.find("x").count, 5);
+    EXPECT_EQ(small.find("x").error, 0);
+
+    auto moved = std::move(small);
+    moved.insert("x");
+    EXPECT_EQ(moved.find("x").count, 6);
+}
+
+TEST(HeavyHitters, MovedFromKeepsValidKeys) {
+    andwass::heavy_hitters source(64);
+    source.insert("seed");
+    andwass::heavy_hitters target(std::move(source));
+    // A moved-from tracker has no reserved storage left and grows as keys are inserted.
+    source = andwass::heavy_hitters(64);
+    andwass::heavy_hitters reused(std::move(target));
+    std::vector<std::string> keys;
+    for (int i = 0; i < 64; i++) {
+        keys.push_back("k" + std::to_string(i));
+    }
+    for (int round = 0; round < 3; round++) {
+        for (const auto& key: keys) {
+            target.insert(as_view(key));
+        }
+    }
+    for (const auto& key: keys) {
+        EXPECT_EQ(target.find(as_view(key)).count, 3) << key;
+        EXPECT_EQ(target.find(as_view(key)).key, as_view(key));
+    }
+    EXPECT_EQ(reused.find("seed").count, 1);
+}
+
+TEST(HeavyHitters, EvictedKeysOfAnyLength) {
+    andwass::heavy_hitters hh(8);
+    std::mt19937 rng(70);
+    std::vector<std::string> keys;
+    for (int i = 0; i < 200; i++) {
+        keys.push_back(std::string(rng() % 100, 'a' + static_cast<char>(i % 26)) + std::to_string(i));
+    }
+    for (int round = 0; round < 4; round++) {
+        for (const auto& key: keys) {
+            hh.insert(as_view(key));
+            const auto found = hh.find(as_view(key));
+            ASSERT_GE(found.count, 1);
+            ASSERT_EQ(found.key, as_view(key));
+        }
+    }
+    EXPECT_EQ(hh.size(), 8);
+    EXPECT_EQ(hh.total(), 800);
+    for (const auto& e: hh.top(8)) {
+        EXPECT_EQ(hh.find(e.key).key, e.key);
+    }
+}
+
+#pragma clang diagnostic pop
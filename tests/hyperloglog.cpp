@@ -0,0 +1,79 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/hyperloglog.hpp>
+
+#include <cmath>
+#include <string>
+
+namespace {
+void insert_range(andwass::hyperloglog& hll, const std::string& prefix, int first, int last) {
+    for (int i = first; i < last; i++) {
+        const auto str = prefix + std::to_string(i);
+        hll.insert(andwass::string_view(str.data(), str.size()));
+    }
+}
+
+double relative_error(double estimate, double actual) {
+    return std::abs(estimate - actual) / actual;
+}
+}// namespace
+
+TEST(HyperLogLog, Construction) {
+    andwass::hyperloglog hll;
+    EXPECT_EQ(hll.precision(), 14);
+    EXPECT_TRUE(hll.is_sparse());
+    EXPECT_EQ(hll.estimate(), 0);
+    EXPECT_THROW(andwass::hyperloglog(3), std::invalid_argument);
+    EXPECT_THROW(andwass::hyperloglog(19), std::invalid_argument);
+}
+
+TEST(HyperLogLog, SmallCardinalities) {
+    andwass::hyperloglog hll;
+    hll.insert("a");
+    hll.insert("a");
+    hll.insert("b");
+    EXPECT_NEAR(hll.estimate(), 2, 0.01);
+    insert_range(hll, "x", 0, 1000);
+    EXPECT_TRUE(hll.is_sparse());
+    EXPECT_LT(relative_error(hll.estimate(), 1002), 0.02);
+}
+
+TEST(HyperLogLog, LargeCardinalities) {
+    andwass::hyperloglog hll(12);
+    insert_range(hll, "user-", 0, 200000);
+    EXPECT_FALSE(hll.is_sparse());
+    // 5 standard errors
+    EXPECT_LT(relative_error(hll.estimate(), 200000), 5 * 1.04 / 64);
+    insert_range(hll, "user-", 0, 200000);
+    EXPECT_LT(relative_error(hll.estimate(), 200000), 5 * 1.04 / 64);
+
+    hll.clear();
+    EXPECT_TRUE(hll.is_sparse());
+    EXPECT_EQ(hll.estimate(), 0);
+}
+
+TEST(HyperLogLog, Merge) {
+    andwass::hyperloglog a(10), b(10), c(10), all(10);
+    insert_range(a, "k", 0, 50000);
+    insert_range(b, "k", 25000, 75000);
+    insert_range(c, "k", 74990, 75010);
+    insert_range(all, "k", 0, 75010);
+    EXPECT_FALSE(a.is_sparse());
+    EXPECT_TRUE(c.is_sparse());
+
+    auto merged = c;
+    merged.merge(a);
+    merged.merge(b);
+    EXPECT_EQ(merged.estimate(), all.estimate());
+
+    auto sparse_only = andwass::hyperloglog(10);
+    sparse_only.merge(c);
+    EXPECT_TRUE(sparse_only.is_sparse());
+    EXPECT_EQ(sparse_only.estimate(), c.estimate());
+
+    EXPECT_THROW(a.merge(andwass::hyperloglog(11)), std::invalid_argument);
+}
+
+#pragma clang diagnostic pop
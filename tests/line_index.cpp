@@ -0,0 +1,65 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/line_index.hpp>
+
+#include <string>
+
+TEST(LineIndex, Lines) {
+    using andwass::operator""_sv;
+    andwass::line_index index("first\nsecond\n\nfourth"_sv);
+
+    EXPECT_EQ(index.line_count(), 4);
+    EXPECT_EQ(index.line(0), "first");
+    EXPECT_EQ(index.line(1), "second");
+    EXPECT_EQ(index.line(2), "");
+    EXPECT_EQ(index.line(3), "fourth");
+    EXPECT_EQ(index.line_start(3), 14);
+    EXPECT_THROW((void)index.line(4), std::out_of_range);
+
+    andwass::line_index trailing("a\n"_sv);
+    EXPECT_EQ(trailing.line_count(), 2);
+    EXPECT_EQ(trailing.line(1), "");
+
+    andwass::line_index empty(""_sv);
+    EXPECT_EQ(empty.line_count(), 1);
+    EXPECT_EQ(empty.line(0), "");
+}
+
+TEST(LineIndex, Position) {
+    using andwass::operator""_sv;
+    auto text = "first\nsecond\n\nfourth"_sv;
+    andwass::line_index index(text);
+
+    EXPECT_EQ(index.position(0), (andwass::line_column{0, 0}));
+    EXPECT_EQ(index.position(5), (andwass::line_column{0, 5}));
+    EXPECT_EQ(index.position(6), (andwass::line_column{1, 0}));
+    EXPECT_EQ(index.position(text.find("cond")), (andwass::line_column{1, 2}));
+    EXPECT_EQ(index.position(13), (andwass::line_column{2, 0}));
+    EXPECT_EQ(index.position(text.size()), (andwass::line_column{3, 6}));
+    EXPECT_THROW((void)index.position(text.size() + 1), std::out_of_range);
+
+    EXPECT_EQ(index.offset({1, 2}), text.find("cond"));
+    EXPECT_EQ(index.offset({3, 6}), text.size());
+    EXPECT_EQ(index.offset({2, 1}), andwass::string_view::npos);
+    EXPECT_EQ(index.offset({4, 0}), andwass::string_view::npos);
+}
+
+TEST(LineIndex, RoundTrip) {
+    std::string lines;
+    for (int i = 0; i < 1000; i++) {
+        lines += std::string(static_cast<size_t>(i % 17), 'x') + "\n";
+    }
+    andwass::string_view text(lines.data(), lines.size());
+    andwass::line_index index(text);
+    EXPECT_EQ(index.line_count(), 1001);
+
+    for (size_t offset = 0; offset <= text.size(); offset++) {
+        auto pos = index.position(offset);
+        ASSERT_EQ(index.offset(pos), offset);
+        ASSERT_LE(pos.column, index.line(pos.line).size());
+    }
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,90 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/prefix_table.hpp>
+
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(PrefixTable, LongestMatch) {
+    andwass::prefix_table<int> routes;
+    EXPECT_FALSE(routes.longest_match("/api"));
+
+    EXPECT_TRUE(routes.insert("/", 1));
+    EXPECT_TRUE(routes.insert("/api/", 2));
+    EXPECT_TRUE(routes.insert("/api/v1/", 3));
+    EXPECT_TRUE(routes.insert("/api/v1/users", 4));
+    EXPECT_FALSE(routes.insert("/", 5));
+    EXPECT_EQ(routes.size(), 4);
+    EXPECT_EQ(*routes.find("/"), 5);
+    EXPECT_EQ(routes.find("/api"), nullptr);
+
+    auto found = routes.longest_match("/api/v1/users/42");
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found.prefix, "/api/v1/users");
+    EXPECT_EQ(*found.value, 4);
+
+    EXPECT_EQ(routes.longest_match("/api/v1/orders").prefix, "/api/v1/");
+    EXPECT_EQ(routes.longest_match("/api/v2/orders").prefix, "/api/");
+    EXPECT_EQ(routes.longest_match("/api").prefix, "/");
+    EXPECT_EQ(*routes.longest_match("/api").value, 5);
+    EXPECT_FALSE(routes.longest_match("api"));
+    EXPECT_FALSE(routes.longest_match(""));
+
+    routes.insert("", 0);
+    EXPECT_EQ(*routes.longest_match("api").value, 0);
+}
+
+TEST(PrefixTable, MatchBatch) {
+    std::mt19937 rng(11);
+    auto random_path = [&](size_t max_len) {
+        std::string path;
+        const auto len = rng() % max_len;
+        for (size_t i = 0; i < len; i++) {
+            path += "ab/"[rng() % 3];
+        }
+        return path;
+    };
+    andwass::prefix_table<size_t> table;
+    std::vector<std::string> prefixes;
+    for (size_t i = 0; i < 300; i++) {
+        prefixes.push_back(random_path(10));
+        table.insert({prefixes.back().data(), prefixes.back().size()}, i);
+    }
+
+    std::vector<std::string> keys;
+    std::vector<andwass::string_view> views;
+    for (int i = 0; i < 500; i++) {
+        keys.push_back(random_path(14));
+    }
+    for (const auto& key: keys) {
+        views.emplace_back(key.data(), key.size());
+    }
+
+    std::vector<andwass::prefix_table<size_t>::match> results;
+    table.match_batch(views.begin(), views.end(), std::back_inserter(results));
+    ASSERT_EQ(results.size(), keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        // Brute force, the longest registered prefix.
+        std::string expected;
+        bool any = false;
+        for (const auto& prefix: prefixes) {
+            if (keys[i].compare(0, prefix.size(), prefix) == 0 && prefix.size() <= keys[i].size() && (!any || prefix.size() > expected.size())) {
+                expected = prefix;
+                any = true;
+            }
+        }
+        const auto single = table.longest_match(views[i]);
+        ASSERT_EQ(static_cast<bool>(results[i]), any) << keys[i];
+        ASSERT_EQ(static_cast<bool>(single), any);
+        if (any) {
+            ASSERT_EQ(results[i].prefix, andwass::string_view(expected.data(), expected.size())) << keys[i];
+            ASSERT_EQ(results[i].value, single.value);
+        }
+    }
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,107 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/prefixed_view.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(PrefixedView, Construction) {
+    andwass::prefixed_view empty;
+    EXPECT_TRUE(empty.is_empty());
+    EXPECT_EQ(empty.view(), "");
+
+    const char* short_str = "hello world!";
+    andwass::prefixed_view inline_view(short_str);
+    EXPECT_TRUE(inline_view.is_inline());
+    EXPECT_EQ(inline_view.size(), 12);
+    EXPECT_EQ(inline_view.view(), "hello world!");
+    EXPECT_NE(inline_view.data(), short_str);
+
+    const char* long_str = "hello world, this is long";
+    andwass::prefixed_view long_view(long_str);
+    EXPECT_FALSE(long_view.is_inline());
+    EXPECT_EQ(long_view.data(), long_str);
+    EXPECT_EQ(long_view.view(), long_str);
+
+    andwass::string_view sv = long_view;
+    EXPECT_EQ(sv, long_str);
+}
+
+TEST(PrefixedView, Equality) {
+    using andwass::prefixed_view;
+    std::string a = "a string longer than twelve";
+    std::string b = a;
+    EXPECT_EQ(prefixed_view(andwass::string_view(a.data(), a.size())), prefixed_view(andwass::string_view(b.data(), b.size())));
+    b.back() = 'x';
+    EXPECT_NE(prefixed_view(andwass::string_view(a.data(), a.size())), prefixed_view(andwass::string_view(b.data(), b.size())));
+
+    EXPECT_EQ(prefixed_view("short"), prefixed_view("short"));
+    EXPECT_NE(prefixed_view("short"), prefixed_view("shorT"));
+    EXPECT_NE(prefixed_view("short"), prefixed_view("shorts"));
+    EXPECT_NE(prefixed_view({"ab\0", 3}), prefixed_view("ab"));
+    EXPECT_EQ(prefixed_view(""), prefixed_view());
+}
+
+TEST(PrefixedView, MixedEquality) {
+    using andwass::prefixed_view;
+    using andwass::string_view;
+    std::string long_str = "a string longer than twelve";
+    const string_view long_view(long_str.data(), long_str.size());
+    const prefixed_view long_pv(long_view);
+    const prefixed_view short_pv("short");
+
+    EXPECT_TRUE(long_pv == long_view);
+    EXPECT_TRUE(long_view == long_pv);
+    EXPECT_FALSE(long_pv != long_view);
+    EXPECT_FALSE(long_view != long_pv);
+
+    EXPECT_TRUE(short_pv == string_view("short"));
+    EXPECT_TRUE(string_view("short") == short_pv);
+    EXPECT_TRUE(short_pv != string_view("shorT"));
+    EXPECT_TRUE(string_view("shorts") != short_pv);
+    EXPECT_TRUE(short_pv != long_view);
+    EXPECT_TRUE(long_view != short_pv);
+}
+
+TEST(PrefixedView, Ordering) {
+    using andwass::prefixed_view;
+    EXPECT_LT(prefixed_view("abc"), prefixed_view("abd"));
+    EXPECT_LT(prefixed_view("ab"), prefixed_view("abc"));
+    EXPECT_LT(prefixed_view("ab"), prefixed_view({"ab\0", 3}));
+    EXPECT_LT(prefixed_view("abcd-long-string-1"), prefixed_view("abcd-long-string-2"));
+    EXPECT_LT(prefixed_view("z"), prefixed_view("\xff"));
+    EXPECT_GT(prefixed_view("b"), prefixed_view("abcdefghijklmnop"));
+    EXPECT_EQ(prefixed_view("abcdefghijklmnop").compare(prefixed_view("abcdefghijklmnop")), 0);
+
+    std::mt19937 rng(21);
+    std::vector<std::string> strings;
+    for (int i = 0; i < 500; i++) {
+        std::string str;
+        const auto len = rng() % 20;
+        for (size_t j = 0; j < len; j++) {
+            str += static_cast<char>(rng() % 3 == 0 ? rng() % 256 : 'a' + rng() % 2);
+        }
+        strings.push_back(str);
+    }
+    std::vector<prefixed_view> views;
+    for (const auto& str: strings) {
+        views.emplace_back(andwass::string_view(str.data(), str.size()));
+    }
+    for (size_t i = 0; i + 1 < strings.size(); i++) {
+        const auto expected = strings[i].compare(strings[i + 1]);
+        const auto actual = views[i].compare(views[i + 1]);
+        ASSERT_EQ(expected < 0, actual < 0);
+        ASSERT_EQ(expected == 0, actual == 0);
+        ASSERT_EQ(strings[i] == strings[i + 1], views[i] == views[i + 1]);
+    }
+}
+
+TEST(PrefixedView, Hash) {
+    EXPECT_EQ(std::hash<andwass::prefixed_view>()(andwass::prefixed_view("abc")), std::hash<andwass::string_view>()("abc"));
+}
+
+#pragma clang diagnostic pop
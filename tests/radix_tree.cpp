@@ -0,0 +1,225 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/radix_tree.hpp>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+andwass::string_view view(const std::string& str) {
+    return {str.data(), str.size()};
+}
+
+template<class Tree>
+std::vector<std::pair<std::string, int>> collect(const Tree& tree) {
+    std::vector<std::pair<std::string, int>> retval;
+    tree.for_each([&](andwass::string_view key, const int& value) {
+        retval.emplace_back(std::string(key.data(), key.size()), value);
+    });
+    return retval;
+}
+}
+
+TEST(RadixTree, InsertFind) {
+    andwass::radix_tree<int> tree;
+    EXPECT_TRUE(tree.is_empty());
+    EXPECT_EQ(tree.find("a"), nullptr);
+
+    EXPECT_TRUE(tree.try_emplace("romane", 1).second);
+    EXPECT_TRUE(tree.try_emplace("romanus", 2).second);
+    EXPECT_TRUE(tree.try_emplace("romulus", 3).second);
+    EXPECT_TRUE(tree.try_emplace("rom", 4).second);
+    EXPECT_TRUE(tree.try_emplace("", 5).second);
+    EXPECT_TRUE(tree.try_emplace("rubens", 6).second);
+    EXPECT_FALSE(tree.try_emplace("rom", 7).second);
+    EXPECT_EQ(tree.size(), 6);
+
+    EXPECT_EQ(*tree.find("romane"), 1);
+    EXPECT_EQ(*tree.find("romanus"), 2);
+    EXPECT_EQ(*tree.find("romulus"), 3);
+    EXPECT_EQ(*tree.find("rom"), 4);
+    EXPECT_EQ(*tree.find(""), 5);
+    EXPECT_EQ(*tree.find("rubens"), 6);
+    EXPECT_EQ(tree.find("roman"), nullptr);
+    EXPECT_EQ(tree.find("ro"), nullptr);
+    EXPECT_EQ(tree.find("romanes"), nullptr);
+    EXPECT_FALSE(tree.contains("x"));
+
+    EXPECT_FALSE(tree.insert_or_assign("rom", 8).second);
+    EXPECT_EQ(*tree.find("rom"), 8);
+    tree["roman"] += 9;
+    EXPECT_EQ(*tree.find("roman"), 9);
+    EXPECT_EQ(tree.size(), 7);
+
+    auto moved = std::move(tree);
+    EXPECT_EQ(moved.size(), 7);
+    EXPECT_EQ(tree.size(), 0);
+    EXPECT_EQ(*moved.find("romulus"), 3);
+}
+
+TEST(RadixTree, PrefixAndRange) {
+    andwass::radix_tree<int> tree;
+    const std::vector<std::string> keys{"api", "api/v1", "api/v1/users", "api/v1/users/42", "api/v2", "app", "b"};
+    for (size_t i = 0; i < keys.size(); i++) {
+        tree.try_emplace(view(keys[i]), static_cast<int>(i));
+    }
+
+    std::vector<std::string> found;
+    auto collect_keys = [&](andwass::string_view key, const int&) {
+        found.emplace_back(key.data(), key.size());
+    };
+    tree.for_each_prefix("api/v1", collect_keys);
+    EXPECT_EQ(found, (std::vector<std::string>{"api/v1", "api/v1/users", "api/v1/users/42"}));
+
+    found.clear();
+    tree.for_each_prefix("ap", collect_keys);
+    EXPECT_EQ(found.size(), 6);
+
+    found.clear();
+    tree.for_each_prefix("api/v1/u", collect_keys);
+    EXPECT_EQ(found, (std::vector<std::string>{"api/v1/users", "api/v1/users/42"}));
+
+    found.clear();
+    tree.for_each_prefix("api/v3", collect_keys);
+    EXPECT_TRUE(found.empty());
+
+    found.clear();
+    tree.for_each_range("api/v1/users", "app", collect_keys);
+    EXPECT_EQ(found, (std::vector<std::string>{"api/v1/users", "api/v1/users/42", "api/v2"}));
+
+    found.clear();
+    tree.for_each_range("", "api/v1", collect_keys);
+    EXPECT_EQ(found, (std::vector<std::string>{"api"}));
+}
+
+TEST(RadixTree, AgreesWithMap) {
+    std::mt19937 rng(5);
+    andwass::radix_tree<int> tree;
+    std::map<std::string, int> expected;
+    for (int i = 0; i < 20000; i++) {
+        std::string key;
+        const auto len = rng() % 6;
+        for (size_t j = 0; j < len; j++) {
+            // A wide alphabet at the first byte grows nodes all the way to node256.
+            key += static_cast<char>(j == 0 ? rng() % 256 : 'a' + rng() % 4);
+        }
+        const bool inserted = tree.try_emplace(view(key), i).second;
+        ASSERT_EQ(inserted, expected.emplace(key, i).second);
+    }
+    EXPECT_EQ(tree.size(), expected.size());
+    for (const auto& kv: expected) {
+        ASSERT_NE(tree.find(view(kv.first)), nullptr);
+        ASSERT_EQ(*tree.find(view(kv.first)), kv.second);
+    }
+    EXPECT_EQ(collect(tree), (std::vector<std::pair<std::string, int>>(expected.begin(), expected.end())));
+
+    for (int i = 0; i < 200; i++) {
+        std::string a(1, static_cast<char>(rng() % 256));
+        a += static_cast<char>('a' + rng() % 4);
+        std::string b(1, static_cast<char>(rng() % 256));
+        if (b < a) {
+            std::swap(a, b);
+        }
+        std::vector<std::pair<std::string, int>> range;
+        tree.for_each_range(view(a), view(b), [&](andwass::string_view key, const int& value) {
+            range.emplace_back(std::string(key.data(), key.size()), value);
+        });
+        ASSERT_EQ(range, (std::vector<std::pair<std::string, int>>(expected.lower_bound(a), expected.lower_bound(b))));
+
+        std::vector<std::pair<std::string, int>> prefixed;
+        tree.for_each_prefix(view(a), [&](andwass::string_view key, const int& value) {
+            prefixed.emplace_back(std::string(key.data(), key.size()), value);
+        });
+        std::vector<std::pair<std::string, int>> expected_prefixed;
+        for (auto it = expected.lower_bound(a); it != expected.end() && it->first.compare(0, a.size(), a) == 0; ++it) {
+            expected_prefixed.push_back(*it);
+        }
+        ASSERT_EQ(prefixed, expected_prefixed);
+    }
+}
+
+TEST(RadixTree, Erase) {
+    andwass::radix_tree<int> tree;
+    tree.try_emplace("api", 1);
+    tree.try_emplace("api/v1", 2);
+    tree.try_emplace("api/v2", 3);
+    tree.try_emplace("apple", 4);
+
+    EXPECT_FALSE(tree.erase("ap"));
+    EXPECT_FALSE(tree.erase("api/v3"));
+    EXPECT_FALSE(tree.erase("api/v1/x"));
+    EXPECT_TRUE(tree.erase("api"));
+    EXPECT_FALSE(tree.erase("api"));
+    EXPECT_EQ(tree.size(), 3u);
+    EXPECT_EQ(tree.find("api"), nullptr);
+    EXPECT_EQ(*tree.find("api/v1"), 2);
+    EXPECT_EQ(tree.longest_prefix("api/v2/users").first, "api/v2");
+    EXPECT_EQ(tree.longest_prefix("api/v3").second, nullptr);
+
+    EXPECT_TRUE(tree.erase("api/v1"));
+    EXPECT_TRUE(tree.erase("apple"));
+    EXPECT_EQ(collect(tree), (std::vector<std::pair<std::string, int>>{{"api/v2", 3}}));
+    EXPECT_TRUE(tree.erase("api/v2"));
+    EXPECT_TRUE(tree.is_empty());
+    EXPECT_FALSE(tree.erase(""));
+
+    tree.try_emplace("", 5);
+    tree.try_emplace("a", 6);
+    EXPECT_TRUE(tree.erase(""));
+    EXPECT_EQ(collect(tree), (std::vector<std::pair<std::string, int>>{{"a", 6}}));
+}
+
+TEST(RadixTree, EraseAgreesWithMap) {
+    std::mt19937 rng(11);
+    andwass::radix_tree<int> tree;
+    std::map<std::string, int> expected;
+    auto random_key = [&] {
+        std::string key;
+        const auto len = rng() % 6;
+        for (size_t j = 0; j < len; j++) {
+            key += static_cast<char>(j == 0 ? rng() % 256 : 'a' + rng() % 4);
+        }
+        return key;
+    };
+    // Grow nodes to their largest layouts, then erase most keys so they shrink and merge again.
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 10000; i++) {
+            const auto key = random_key();
+            ASSERT_EQ(tree.try_emplace(view(key), i).second, expected.emplace(key, i).second);
+        }
+        for (int i = 0; i < 12000; i++) {
+            const auto key = random_key();
+            ASSERT_EQ(tree.erase(view(key)), expected.erase(key) == 1) << key;
+        }
+        ASSERT_EQ(tree.size(), expected.size());
+        ASSERT_EQ(collect(tree), (std::vector<std::pair<std::string, int>>(expected.begin(), expected.end())));
+        for (int i = 0; i < 500; i++) {
+            const auto key = random_key() + "ab";
+            std::string best;
+            const int* best_value = nullptr;
+            for (size_t len = 0; len <= key.size(); len++) {
+                auto it = expected.find(key.substr(0, len));
+                if (it != expected.end()) {
+                    best = it->first;
+                    best_value = &it->second;
+                }
+            }
+            const auto found = tree.longest_prefix(view(key));
+            ASSERT_EQ(found.second == nullptr, best_value == nullptr) << key;
+            if (best_value) {
+                ASSERT_EQ(std::string(found.first.data(), found.first.size()), best);
+                ASSERT_EQ(*found.second, *best_value);
+            }
+        }
+    }
+    for (const auto& kv: std::map<std::string, int>(expected)) {
+        ASSERT_TRUE(tree.erase(view(kv.first)));
+    }
+    EXPECT_TRUE(tree.is_empty());
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,146 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/regex.hpp>
+
+#include <random>
+#include <regex>
+#include <string>
+
+TEST(Regex, Match) {
+    andwass::regex uuid("[0-9a-f]+(-[0-9a-f]+)*");
+    EXPECT_TRUE(uuid.match("123e4567-e89b-12d3-a456-426614174000"));
+    EXPECT_FALSE(uuid.match("123e4567-e89b-12d3-a456-42661417400g"));
+    EXPECT_FALSE(uuid.match("-123e4567"));
+
+    andwass::regex ipv4("\\d+\\.\\d+\\.\\d+\\.\\d+");
+    EXPECT_TRUE(ipv4.match("192.168.0.1"));
+    EXPECT_FALSE(ipv4.match("192.168.0"));
+    EXPECT_FALSE(ipv4.match("192.168.0.1 "));
+
+    andwass::regex alternation("GET|POST|PUT");
+    EXPECT_TRUE(alternation.match("POST"));
+    EXPECT_FALSE(alternation.match("PATCH"));
+    EXPECT_FALSE(alternation.match("GETPOST"));
+
+    andwass::regex optional("colou?r");
+    EXPECT_TRUE(optional.match("color"));
+    EXPECT_TRUE(optional.match("colour"));
+    EXPECT_FALSE(optional.match("colouur"));
+
+    andwass::regex empty("");
+    EXPECT_TRUE(empty.match(""));
+    EXPECT_FALSE(empty.match("a"));
+}
+
+TEST(Regex, Search) {
+    andwass::regex ipv4("\\d+\\.\\d+\\.\\d+\\.\\d+");
+    EXPECT_TRUE(ipv4.search("connection from 10.0.0.12 refused"));
+    EXPECT_FALSE(ipv4.search("connection from localhost refused"));
+
+    andwass::regex starts("^GET ");
+    EXPECT_TRUE(starts.search("GET /index.html"));
+    EXPECT_FALSE(starts.search("POST /GET "));
+
+    andwass::regex ends("\\.json$");
+    EXPECT_TRUE(ends.search("config.json"));
+    EXPECT_FALSE(ends.search("config.json.bak"));
+
+    andwass::regex both("^a+$");
+    EXPECT_TRUE(both.search("aaa"));
+    EXPECT_FALSE(both.search("aab"));
+
+    andwass::regex literal_dollar("a\\$");
+    EXPECT_TRUE(literal_dollar.search("xa$x"));
+
+    EXPECT_TRUE(andwass::regex("").search("abc"));
+}
+
+TEST(Regex, Classes) {
+    EXPECT_TRUE(andwass::regex("[a-c_]+").match("ab_c"));
+    EXPECT_FALSE(andwass::regex("[a-c_]+").match("abd"));
+    EXPECT_TRUE(andwass::regex("[^0-9]+").match("abc"));
+    EXPECT_FALSE(andwass::regex("[^0-9]+").match("a1c"));
+    EXPECT_TRUE(andwass::regex("[]a]+").match("]a]"));
+    EXPECT_TRUE(andwass::regex("[a-]+").match("a-a"));
+    EXPECT_TRUE(andwass::regex("[\\d.]+").match("1.5"));
+    EXPECT_TRUE(andwass::regex("[\\]]").match("]"));
+    EXPECT_TRUE(andwass::regex("\\w+\\s\\W").match("ab_9 !"));
+    EXPECT_TRUE(andwass::regex("a.c").match("a-c"));
+    EXPECT_FALSE(andwass::regex("a.c").match("a\nc"));
+}
+
+TEST(Regex, InvalidPatterns) {
+    EXPECT_THROW(andwass::regex("(ab"), std::invalid_argument);
+    EXPECT_THROW(andwass::regex("ab)"), std::invalid_argument);
+    EXPECT_THROW(andwass::regex("*a"), std::invalid_argument);
+    EXPECT_THROW(andwass::regex("a|+"), std::invalid_argument);
+    EXPECT_THROW(andwass::regex("[abc"), std::invalid_argument);
+    EXPECT_THROW(andwass::regex("[z-a]"), std::invalid_argument);
+    EXPECT_THROW(andwass::regex("a^b"), std::invalid_argument);
+    EXPECT_THROW(andwass::regex("a\\"), std::invalid_argument);
+}
+
+TEST(Regex, BoundedStateCache) {
+    // (a|b)*a(a|b)^n needs 2^n DFA states, the cache keeps flushing but results stay correct.
+    andwass::regex re("(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)", 8);
+    std::string text;
+    std::mt19937 rng(42);
+    for (int i = 0; i < 2000; i++) {
+        text += rng() % 2 ? 'a' : 'b';
+    }
+    const std::regex expected("(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)");
+    for (size_t len = 0; len < 64; len++) {
+        const auto part = text.substr(text.size() - len);
+        ASSERT_EQ(re.match({part.data(), part.size()}), std::regex_match(part, expected)) << part;
+    }
+    EXPECT_EQ(re.match({text.data(), text.size()}), std::regex_match(text, expected));
+}
+
+TEST(Regex, AgreesWithStdRegex) {
+    std::mt19937 rng(1234);
+    auto random_pattern = [&](auto& self, int depth) -> std::string {
+        std::string out;
+        const auto parts = 1 + rng() % 3;
+        for (size_t i = 0; i < parts; i++) {
+            const auto kind = rng() % (depth > 0 ? 6 : 4);
+            if (kind < 2) {
+                out += static_cast<char>('a' + rng() % 2);
+            }
+            else if (kind == 2) {
+                out += '.';
+            }
+            else if (kind == 3) {
+                out += "[a]";
+            }
+            else if (kind == 4) {
+                out += "(" + self(self, depth - 1) + ")";
+            }
+            else {
+                out += "(" + self(self, depth - 1) + "|" + self(self, depth - 1) + ")";
+            }
+            const auto quant = rng() % 5;
+            if (quant < 3) {
+                out += "*+?"[quant];
+            }
+        }
+        return out;
+    };
+    for (int iter = 0; iter < 300; iter++) {
+        const auto pattern = random_pattern(random_pattern, 2);
+        const andwass::regex re(andwass::string_view(pattern.data(), pattern.size()));
+        const std::regex expected(pattern);
+        for (int t = 0; t < 20; t++) {
+            std::string text;
+            const auto len = rng() % 8;
+            for (size_t i = 0; i < len; i++) {
+                text += static_cast<char>('a' + rng() % 3);
+            }
+            ASSERT_EQ(re.match({text.data(), text.size()}), std::regex_match(text, expected)) << pattern << " " << text;
+            ASSERT_EQ(re.search({text.data(), text.size()}), std::regex_search(text, expected)) << pattern << " " << text;
+        }
+    }
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,106 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/rolling_hash.hpp>
+
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+andwass::string_view as_view(const std::string& str) {
+    return andwass::string_view(str.data(), str.size());
+}
+}// namespace
+
+TEST(RollingHash, RollMatchesDirectHash) {
+    constexpr andwass::rolling_hash constant_hash(3);
+    static_assert(constant_hash("abc") == ((std::uint64_t('a') * andwass::rolling_hash::default_base + 'b') * andwass::rolling_hash::default_base + 'c'));
+
+    std::mt19937 rng(75);
+    std::string text;
+    for (int i = 0; i < 1000; i++) {
+        text += static_cast<char>(rng() % 256);
+    }
+    const auto view = as_view(text);
+    for (size_t window: {1, 7, 32}) {
+        andwass::rolling_hash hash(window);
+        EXPECT_EQ(hash.window_size(), window);
+        hash.reset(view);
+        for (size_t pos = 0; pos + window < text.size(); pos++) {
+            ASSERT_EQ(hash.value(), hash(view.substr(pos)));
+            hash.roll(text[pos], text[pos + window]);
+        }
+    }
+}
+
+TEST(RabinKarpSearcher, Basic) {
+    andwass::rabin_karp_searcher searcher{"abc", "bcd", "xyz", "abc"};
+    EXPECT_EQ(searcher.size(), 4);
+    EXPECT_EQ(searcher.pattern_size(), 3);
+    EXPECT_EQ(searcher[2], "xyz");
+
+    std::vector<std::pair<size_t, size_t>> matches;
+    searcher.for_each_match("zabcdxyz", [&](size_t pos, size_t id) {
+        matches.emplace_back(pos, id);
+        return true;
+    });
+    EXPECT_EQ(matches, (std::vector<std::pair<size_t, size_t>>{{1, 0}, {1, 3}, {2, 1}, {5, 2}}));
+
+    EXPECT_EQ(searcher.find("--bcd--abc"), std::make_pair(size_t(2), size_t(1)));
+    EXPECT_EQ(searcher.find("ab"), std::make_pair(searcher.npos, searcher.npos));
+    EXPECT_TRUE(searcher.contains("xyz"));
+    EXPECT_FALSE(searcher.contains("xy-z"));
+
+    EXPECT_THROW((andwass::rabin_karp_searcher{"abc", "ab"}), std::invalid_argument);
+    EXPECT_THROW((andwass::rabin_karp_searcher{""}), std::invalid_argument);
+    std::vector<andwass::string_view> none;
+    EXPECT_THROW(andwass::rabin_karp_searcher(none.begin(), none.end()), std::invalid_argument);
+}
+
+TEST(RabinKarpSearcher, ManyTokens) {
+    std::mt19937 rng(751);
+    auto random_token = [&] {
+        std::string token;
+        for (int i = 0; i < 32; i++) {
+            token += static_cast<char>('a' + rng() % 16);
+        }
+        return token;
+    };
+    std::vector<std::string> tokens;
+    for (int i = 0; i < 2000; i++) {
+        tokens.push_back(random_token());
+    }
+    std::vector<andwass::string_view> views;
+    for (const auto& token: tokens) {
+        views.push_back(as_view(token));
+    }
+    andwass::rabin_karp_searcher searcher(views.begin(), views.end());
+
+    std::string haystack;
+    std::vector<std::pair<size_t, size_t>> expected;
+    for (int i = 0; i < 300; i++) {
+        haystack += random_token().substr(0, rng() % 32);
+        if (i % 3 == 0) {
+            const auto id = rng() % tokens.size();
+            expected.emplace_back(haystack.size(), id);
+            haystack += tokens[id];
+        }
+    }
+    std::vector<std::pair<size_t, size_t>> found;
+    searcher.for_each_match(as_view(haystack), [&](size_t pos, size_t id) {
+        found.emplace_back(pos, id);
+        return true;
+    });
+    EXPECT_EQ(found, expected);
+
+    size_t calls = 0;
+    searcher.for_each_match(as_view(haystack), [&](size_t, size_t) {
+        return ++calls < 3;
+    });
+    EXPECT_EQ(calls, 3);
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,81 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/sorted_string_index.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(SortedStringIndex, Basics) {
+    andwass::sorted_string_index empty;
+    EXPECT_EQ(empty.size(), 0);
+    EXPECT_EQ(empty.lower_bound("a"), 0);
+    EXPECT_FALSE(empty.contains(""));
+
+    andwass::sorted_string_index index{"pear", "apple", "banana", "apple", "apples", "applesauce-extra-long", ""};
+    EXPECT_EQ(index.size(), 6);
+    EXPECT_EQ(index[0], "");
+    EXPECT_EQ(index[1], "apple");
+    EXPECT_EQ(index[5], "pear");
+
+    EXPECT_TRUE(index.contains("apple"));
+    EXPECT_TRUE(index.contains("apples"));
+    EXPECT_TRUE(index.contains(""));
+    EXPECT_FALSE(index.contains("appl"));
+    EXPECT_FALSE(index.contains("applesauce-extra"));
+    EXPECT_EQ(index.lower_bound("appl"), 1);
+    EXPECT_EQ(index.lower_bound("applesauce"), 3);
+    EXPECT_EQ(index.lower_bound("b"), 4);
+    EXPECT_EQ(index.lower_bound("zzz"), 6);
+
+    // Keys that only differ after the cached 8 byte prefix, or by embedded NUL chars.
+    andwass::sorted_string_index tricky{"prefix00a", "prefix00b", "prefix00", {"ab\0", 3}, "ab", "\xff"};
+    EXPECT_EQ(tricky.lower_bound("prefix00ab"), tricky.lower_bound("prefix00b"));
+    EXPECT_TRUE(tricky.contains({"ab\0", 3}));
+    EXPECT_EQ(tricky.lower_bound({"ab\0", 3}), tricky.lower_bound("ab") + 1);
+    EXPECT_EQ(tricky[tricky.size() - 1], "\xff");
+
+    auto moved = std::move(tricky);
+    EXPECT_EQ(moved[0], "ab");
+    EXPECT_TRUE(moved.contains("prefix00"));
+}
+
+TEST(SortedStringIndex, AgreesWithLowerBound) {
+    std::mt19937 rng(17);
+    auto random_key = [&]() {
+        std::string key = rng() % 2 ? "common/prefix/" : "";
+        const auto len = rng() % 12;
+        for (size_t i = 0; i < len; i++) {
+            key += static_cast<char>(rng() % 4 == 0 ? rng() % 256 : 'a' + rng() % 3);
+        }
+        return key;
+    };
+    for (size_t n : {1, 2, 3, 7, 8, 100, 5000}) {
+        std::vector<std::string> keys;
+        for (size_t i = 0; i < n; i++) {
+            keys.push_back(random_key());
+        }
+        std::vector<andwass::string_view> views;
+        for (const auto& key: keys) {
+            views.emplace_back(key.data(), key.size());
+        }
+        andwass::sorted_string_index index(views.begin(), views.end());
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        ASSERT_EQ(index.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            ASSERT_EQ(index[i], andwass::string_view(keys[i].data(), keys[i].size()));
+        }
+        for (int i = 0; i < 1000; i++) {
+            const auto key = random_key();
+            const auto expected = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+            ASSERT_EQ(index.lower_bound({key.data(), key.size()}), expected) << key;
+            ASSERT_EQ(index.contains({key.data(), key.size()}), std::binary_search(keys.begin(), keys.end(), key));
+        }
+    }
+}
+
+#pragma clang diagnostic pop
@@ -4,6 +4,9 @@
 
 #include <andwass/string_view.hpp>
 
+#include <string>
+#include <vector>
+
 TEST(StringView, Construction) {
     auto fn = [](andwass::string_view sv) {
         return sv;
@@ -123,6 +126,27 @@ TEST(StringView, FindNth) {
 
     EXPECT_EQ(data.find_nth("abc", 0), andwass::string_view::npos);
     EXPECT_EQ(andwass::string_view("aaaaaaaaaa").find_nth("a", 5), 5);
+    EXPECT_EQ(andwass::string_view("aaaaaaaaaa").find_nth("aa", 8), 8);
+    EXPECT_EQ(andwass::string_view("aaaaaaaaaa").find_nth("aa", 9), andwass::string_view::npos);
+
+    EXPECT_EQ(data.find_nth("", 3), 3);
+    EXPECT_EQ(data.find_nth("", data.size()), data.size());
+    EXPECT_EQ(data.find_nth("", data.size() + 1), andwass::string_view::npos);
+}
+
+TEST(StringView, FindNthChar) {
+    std::string lines;
+    for (int i = 0; i < 1000; i++) {
+        lines += "line " + std::to_string(i) + "\n";
+    }
+    andwass::string_view data(lines.data(), lines.size());
+
+    EXPECT_EQ(data.find_nth('\n', 0), data.find('\n'));
+    EXPECT_EQ(data.find_nth('\n', 999), data.size() - 1);
+    EXPECT_EQ(data.find_nth('\n', 1000), andwass::string_view::npos);
+    EXPECT_EQ(data.find_nth('l', 500), data.find("line 500"));
+    EXPECT_EQ(data.find_nth("\n", 123), data.find("line 124") - 1);
+    EXPECT_EQ(andwass::string_view().find_nth('a', 0), andwass::string_view::npos);
 }
 
 TEST(StringView, SubStringStartingWith) {
@@ -146,6 +170,85 @@ TEST(StringView, ReverseFind) {
     EXPECT_EQ(data.rfind(""), data.size());
 }
 
+TEST(StringView, ReverseFindNth) {
+    andwass::string_view data("a/b/c/d/e");
+    EXPECT_EQ(data.rfind_nth('/', 0), 7);
+    EXPECT_EQ(data.rfind_nth('/', 2), 3);
+    EXPECT_EQ(data.rfind_nth('/', 3), 1);
+    EXPECT_EQ(data.rfind_nth('/', 4), andwass::string_view::npos);
+    EXPECT_EQ(data.substr(data.rfind_nth('/', 2) + 1), "c/d/e");
+
+    EXPECT_EQ(data.rfind_nth("/d", 0), 5);
+    EXPECT_EQ(data.rfind_nth("/d", 1), andwass::string_view::npos);
+    EXPECT_EQ(andwass::string_view("aaaaa").rfind_nth("aa", 0), 3);
+    EXPECT_EQ(andwass::string_view("aaaaa").rfind_nth("aa", 3), 0);
+    EXPECT_EQ(andwass::string_view("aaaaa").rfind_nth("aa", 4), andwass::string_view::npos);
+    EXPECT_EQ(data.rfind_nth("", 0), data.size());
+    EXPECT_EQ(data.rfind_nth("", data.size()), 0);
+    EXPECT_EQ(data.rfind_nth("", data.size() + 1), andwass::string_view::npos);
+
+    std::string lines;
+    for (int i = 0; i < 1000; i++) {
+        lines += "line " + std::to_string(i) + "\n";
+    }
+    andwass::string_view log(lines.data(), lines.size());
+    EXPECT_EQ(log.rfind_nth('\n', 0), log.size() - 1);
+    EXPECT_EQ(log.rfind_nth('\n', 3) + 1, log.find("line 997"));
+    EXPECT_EQ(log.rfind_nth('\n', 999), log.find('\n'));
+    EXPECT_EQ(log.rfind_nth('\n', 1000), andwass::string_view::npos);
+}
+
+TEST(StringView, ReverseMatches) {
+    andwass::string_view data("ab ab ab");
+    std::vector<size_t> found(data.rmatches("ab").begin(), data.rmatches("ab").end());
+    EXPECT_EQ(found, (std::vector<size_t>{6, 3, 0}));
+
+    andwass::string_view overlapping("aaaa");
+    found.assign(overlapping.rmatches("aa").begin(), overlapping.rmatches("aa").end());
+    EXPECT_EQ(found, (std::vector<size_t>{2, 1, 0}));
+
+    found.assign(data.rmatches("x").begin(), data.rmatches("x").end());
+    EXPECT_TRUE(found.empty());
+
+    found.assign(andwass::string_view("ab").rmatches("").begin(), andwass::string_view("ab").rmatches("").end());
+    EXPECT_EQ(found, (std::vector<size_t>{2, 1, 0}));
+
+    size_t n = 0;
+    for (auto pos: data.rmatches("b")) {
+        EXPECT_EQ(pos, data.rfind_nth('b', n));
+        n++;
+    }
+    EXPECT_EQ(n, 3);
+}
+
+TEST(StringView, Count) {
+    andwass::string_view data("ab ab ab");
+    EXPECT_EQ(data.count('a'), 3);
+    EXPECT_EQ(data.count(' '), 2);
+    EXPECT_EQ(data.count('x'), 0);
+    EXPECT_EQ(andwass::string_view().count('x'), 0);
+
+    EXPECT_EQ(data.count("ab"), 3);
+    EXPECT_EQ(data.count("b"), 3);
+    EXPECT_EQ(data.count("ab ab ab ab"), 0);
+    EXPECT_EQ(data.count(""), data.size() + 1);
+
+    andwass::string_view repeated("aaaa");
+    EXPECT_EQ(repeated.count("aa"), 2);
+    EXPECT_EQ(repeated.count_overlapping("aa"), 3);
+    EXPECT_EQ(repeated.count("aaa"), 1);
+    EXPECT_EQ(repeated.count_overlapping("aaa"), 2);
+
+    std::string lines;
+    for (int i = 0; i < 1000; i++) {
+        lines += "line " + std::to_string(i) + "\n";
+    }
+    andwass::string_view log(lines.data(), lines.size());
+    EXPECT_EQ(log.count('\n'), 1000);
+    EXPECT_EQ(log.count("line"), 1000);
+    EXPECT_EQ(log.count("\nline"), 999);
+}
+
 TEST(StringView, Compare) {
     using andwass::operator""_sv;
 
@@ -155,6 +258,18 @@ TEST(StringView, Compare) {
     EXPECT_TRUE( ""_sv.compare(""_sv) == 0 );
 }
 
+TEST(StringView, Hash) {
+    using andwass::operator""_sv;
+    std::string owned = "hello world";
+    EXPECT_EQ(andwass::hash("hello world"_sv), andwass::hash({owned.data(), owned.size()}));
+    EXPECT_NE(andwass::hash("hello world"_sv), andwass::hash("hello worle"_sv));
+    EXPECT_NE(andwass::hash(""_sv), andwass::hash({"\0", 1}));
+    EXPECT_NE(andwass::hash({"\0", 1}), andwass::hash({"\0\0", 2}));
+    EXPECT_EQ(std::hash<andwass::string_view>()("abc"_sv), static_cast<size_t>(andwass::hash("abc"_sv)));
+
+    static_assert(andwass::hash("abc"_sv) != andwass::hash("abd"_sv));
+}
+
 TEST(StringView, At)
 {
     using andwass::operator""_sv;
@@ -0,0 +1,113 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/suffix_array.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+std::vector<size_t> naive_suffix_array(const std::string& text) {
+    std::vector<size_t> sa(text.size());
+    std::iota(sa.begin(), sa.end(), 0);
+    std::sort(sa.begin(), sa.end(), [&](size_t lhs, size_t rhs) {
+        return text.compare(lhs, std::string::npos, text, rhs, std::string::npos) < 0;
+    });
+    return sa;
+}
+
+std::string random_text(std::mt19937& rng, size_t size, unsigned alphabet) {
+    std::string text;
+    for (size_t i = 0; i < size; i++) {
+        text += static_cast<char>(alphabet == 256 ? rng() % 256 : 'a' + rng() % alphabet);
+    }
+    return text;
+}
+
+std::vector<size_t> naive_find_all(const std::string& text, const std::string& needle) {
+    std::vector<size_t> retval;
+    for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        retval.push_back(pos);
+    }
+    return retval;
+}
+}// namespace
+
+TEST(SuffixArray, Banana) {
+    andwass::suffix_array sa("banana", true);
+    EXPECT_EQ(sa.size(), 6);
+    EXPECT_EQ(sa.positions(), (std::vector<size_t>{5, 3, 1, 0, 4, 2}));
+    EXPECT_TRUE(sa.has_lcp());
+    const std::vector<size_t> lcp{0, 1, 3, 0, 0, 2};
+    for (size_t i = 0; i < lcp.size(); i++) {
+        EXPECT_EQ(sa.lcp(i), lcp[i]);
+    }
+    EXPECT_EQ(sa.find_all("ana"), (std::vector<size_t>{1, 3}));
+    EXPECT_EQ(sa.count("a"), 3);
+    EXPECT_EQ(sa.count("nab"), 0);
+    EXPECT_EQ(sa.count(""), 6);
+    EXPECT_FALSE(sa.contains("bananas"));
+    EXPECT_THROW((void)sa.lcp(6), std::out_of_range);
+}
+
+TEST(SuffixArray, EdgeCases) {
+    andwass::suffix_array empty("", true);
+    EXPECT_EQ(empty.size(), 0);
+    EXPECT_TRUE(empty.find_all("a").empty());
+
+    andwass::suffix_array single("x");
+    EXPECT_FALSE(single.has_lcp());
+    EXPECT_EQ(single.find_all("x"), std::vector<size_t>{0});
+    EXPECT_THROW((void)single.lcp(0), std::out_of_range);
+
+    const std::string runs(1000, 'a');
+    andwass::suffix_array sa(andwass::string_view(runs.data(), runs.size()), true);
+    EXPECT_EQ(sa[0], 999);
+    EXPECT_EQ(sa.lcp(999), 999);
+    EXPECT_EQ(sa.count("aaa"), 998);
+}
+
+TEST(SuffixArray, RandomAgainstNaive) {
+    std::mt19937 rng(72);
+    for (int iter = 0; iter < 200; iter++) {
+        const unsigned alphabet = iter % 4 == 3 ? 256 : 1 + iter % 4;
+        const auto text = random_text(rng, rng() % 300, alphabet);
+        andwass::suffix_array sa(andwass::string_view(text.data(), text.size()), true);
+        const auto expected = naive_suffix_array(text);
+        ASSERT_EQ(sa.positions(), expected) << text;
+        for (size_t i = 1; i < expected.size(); i++) {
+            size_t lcp = 0;
+            while (expected[i - 1] + lcp < text.size() && expected[i] + lcp < text.size()
+                   && text[expected[i - 1] + lcp] == text[expected[i] + lcp]) {
+                lcp++;
+            }
+            ASSERT_EQ(sa.lcp(i), lcp);
+        }
+        for (int q = 0; q < 10; q++) {
+            const auto needle = random_text(rng, 1 + rng() % 4, alphabet);
+            ASSERT_EQ(sa.find_all(andwass::string_view(needle.data(), needle.size())), naive_find_all(text, needle));
+        }
+    }
+}
+
+TEST(SuffixArray, ParallelLcp) {
+    std::mt19937 rng(721);
+    const auto text = random_text(rng, 300000, 3);
+    const andwass::string_view view(text.data(), text.size());
+    andwass::suffix_array sequential(view, true, 1);
+    andwass::suffix_array parallel(view, true, 4);
+    ASSERT_EQ(sequential.positions(), parallel.positions());
+    for (size_t i = 0; i < sequential.size(); i++) {
+        ASSERT_EQ(sequential.lcp(i), parallel.lcp(i));
+    }
+    for (size_t i = 1; i < sequential.size(); i += 997) {
+        ASSERT_LT(text.compare(sequential[i - 1], std::string::npos, text, sequential[i], std::string::npos), 0);
+        ASSERT_EQ(text.compare(sequential[i - 1], sequential.lcp(i), text, sequential[i], sequential.lcp(i)), 0);
+    }
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,90 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#include <gtest/gtest.h>
+
+#include <andwass/trigram_index.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+andwass::string_view as_view(const std::string& str) {
+    return andwass::string_view(str.data(), str.size());
+}
+}// namespace
+
+TEST(TrigramIndex, Basic) {
+    andwass::trigram_index index{"the quick brown fox", "jumps over", "the lazy dog", "", "ox"};
+    EXPECT_EQ(index.size(), 5);
+    EXPECT_EQ(index[2], "the lazy dog");
+    EXPECT_EQ(index.find("the"), (std::vector<size_t>{0, 2}));
+    EXPECT_EQ(index.find("quick brown"), std::vector<size_t>{0});
+    EXPECT_EQ(index.find("ox"), (std::vector<size_t>{0, 4}));
+    EXPECT_EQ(index.find("").size(), 5);
+    EXPECT_TRUE(index.find("cat").empty());
+    EXPECT_TRUE(index.contains("over"));
+    EXPECT_FALSE(index.contains("the fox"));
+    // All trigrams present, but never together in one document.
+    EXPECT_TRUE(index.find("the dog").empty());
+}
+
+TEST(TrigramIndex, LongPostingLists) {
+    std::vector<std::string> docs;
+    for (int i = 0; i < 5000; i++) {
+        docs.push_back("common " + std::to_string(i) + (i % 3 == 0 ? " fizz" : "") + (i % 5 == 0 ? " buzz" : ""));
+    }
+    std::vector<andwass::string_view> views;
+    for (const auto& doc: docs) {
+        views.push_back(as_view(doc));
+    }
+    andwass::trigram_index index(views.begin(), views.end());
+    EXPECT_EQ(index.find("common").size(), 5000);
+    const auto fizzbuzz = index.find("fizz buzz");
+    ASSERT_EQ(fizzbuzz.size(), 334);
+    for (auto doc: fizzbuzz) {
+        EXPECT_EQ(doc % 15, 0);
+    }
+    EXPECT_EQ(index.find("mon 4999"), std::vector<size_t>{4999});
+}
+
+TEST(TrigramIndex, RandomAgainstNaive) {
+    std::mt19937 rng(74);
+    std::vector<std::string> docs;
+    for (int i = 0; i < 3000; i++) {
+        std::string doc;
+        const auto len = rng() % 40;
+        for (size_t j = 0; j < len; j++) {
+            doc += static_cast<char>(j % 7 == 0 ? rng() % 256 : 'a' + rng() % 4);
+        }
+        docs.push_back(doc);
+    }
+    std::vector<andwass::string_view> views;
+    for (const auto& doc: docs) {
+        views.push_back(as_view(doc));
+    }
+    andwass::trigram_index index(views.begin(), views.end());
+    for (int q = 0; q < 300; q++) {
+        std::string needle;
+        const auto& source = docs[rng() % docs.size()];
+        if (q % 2 == 0 && !source.empty()) {
+            needle = source.substr(rng() % source.size(), 1 + rng() % 8);
+        }
+        else {
+            const auto len = 1 + rng() % 6;
+            for (size_t j = 0; j < len; j++) {
+                needle += static_cast<char>('a' + rng() % 4);
+            }
+        }
+        std::vector<size_t> expected;
+        for (size_t d = 0; d < docs.size(); d++) {
+            if (docs[d].find(needle) != std::string::npos) {
+                expected.push_back(d);
+            }
+        }
+        ASSERT_EQ(index.find(as_view(needle)), expected) << needle;
+        ASSERT_EQ(index.contains(as_view(needle)), !expected.empty());
+    }
+}
+
+#pragma clang diagnostic pop